@@ -1,5 +1,5 @@
 @echo off
-bin\lists
+bin\lists --reproducible
 if errorlevel 1 goto error
 mailing\lwg-active.html
 goto done
@@ -1,5 +1,5 @@
 #!/bin/sh
-bin/lists && test -f mailing/lwg-active.html && exit
+bin/lists --reproducible && test -f mailing/lwg-active.html && exit
 echo ***********************************
 echo ********** build failure **********
 echo ***********************************
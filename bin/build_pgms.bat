@@ -1,7 +1,9 @@
 echo "Use -m32 switch to force 32-bit build"
-g++ %* -std=c++11 -DNDEBUG -O2 -o bin/lists.exe  src/date.cpp src/issues.cpp src/sections.cpp src/mailing_info.cpp src/report_generator.cpp src/lists.cpp
-g++ %* -std=c++11 -o bin/section_data.exe src/section_data.cpp
-g++ %* -std=c++11 -o bin/toc_diff.exe src/toc_diff.cpp
-g++ %* -std=c++11 -DNDEBUG -O2 -o bin/list_issues.exe src/date.cpp src/issues.cpp src/sections.cpp src/list_issues.cpp
-g++ %* -std=c++11 -DNDEBUG -O2 -o bin/set_status.exe  src/set_status.cpp
+g++ %* -std=c++11 -DNDEBUG -O2 -pthread -o bin/lists.exe  src/date.cpp src/issues.cpp src/markup_scan.cpp src/issue_directory.cpp src/sections.cpp src/mailing_info.cpp src/report_generator.cpp src/compressed_files.cpp src/issue_export.cpp src/toc_snapshot.cpp src/revision_diff.cpp src/issue_pipeline.cpp src/reference_graph.cpp src/issue_table.cpp src/allocation.cpp src/stage_profile.cpp src/lists.cpp -lz
+g++ %* -std=c++11 -o bin/section_data.exe src/sections.cpp src/section_data.cpp
+g++ %* -std=c++11 -o bin/toc_diff.exe src/date.cpp src/issues.cpp src/markup_scan.cpp src/sections.cpp src/toc_snapshot.cpp src/revision_diff.cpp src/toc_diff.cpp
+g++ %* -std=c++11 -DNDEBUG -O2 -o bin/list_issues.exe src/date.cpp src/issues.cpp src/markup_scan.cpp src/issue_directory.cpp src/sections.cpp src/list_issues.cpp
+g++ %* -std=c++11 -DNDEBUG -O2 -pthread -o bin/set_status.exe src/date.cpp src/issues.cpp src/markup_scan.cpp src/sections.cpp src/set_status.cpp
+g++ %* -std=c++11 -DNDEBUG -O2 -o bin/status_timeline.exe src/date.cpp src/issues.cpp src/markup_scan.cpp src/sections.cpp src/toc_snapshot.cpp src/revision_diff.cpp src/status_timeline.cpp
+g++ %* -std=c++11 -DNDEBUG -O2 -pthread -o bin/lists_bench.exe src/date.cpp src/issues.cpp src/markup_scan.cpp src/issue_directory.cpp src/sections.cpp src/mailing_info.cpp src/report_generator.cpp src/compressed_files.cpp src/issue_export.cpp src/toc_snapshot.cpp src/revision_diff.cpp src/issue_pipeline.cpp src/reference_graph.cpp src/issue_table.cpp src/lists_bench.cpp -lz
 
@@ -3,10 +3,24 @@ rem in a directory named issues-gh-pages, at the same level as the master branch
 pushd ..\issues-gh-pages
 call git pull
 popd
-copy /y mailing\lwg-*.html ..\issues-gh-pages
-copy /y mailing\unresolved-*.html ..\issues-gh-pages
-copy /y mailing\votable-*.html ..\issues-gh-pages
+rem Copy only the documents that changed, so that unchanged pages keep their timestamps,
+rem with the siblings made by 'lists --gzip' or 'lists --brotli'
+for %%f in (mailing\lwg-*.html mailing\lwg-toc.txt mailing\unresolved-*.html mailing\votable-*.html mailing\lwg-*.html.gz mailing\unresolved-*.html.gz mailing\votable-*.html.gz mailing\lwg-*.html.br mailing\unresolved-*.html.br mailing\votable-*.html.br) do (
+   fc /b "%%f" "..\issues-gh-pages\%%~nxf" > nul 2>&1 || copy /y "%%f" ..\issues-gh-pages
+)
+rem Pages for single issues and sections, made by 'lists --issue-pages'
+for %%d in (issues sections) do (
+   if exist mailing\%%d (
+      if not exist ..\issues-gh-pages\%%d mkdir ..\issues-gh-pages\%%d
+      for %%f in (mailing\%%d\*.html mailing\%%d\*.html.gz mailing\%%d\*.html.br) do (
+         fc /b "%%f" "..\issues-gh-pages\%%d\%%~nxf" > nul 2>&1 || copy /y "%%f" ..\issues-gh-pages\%%d
+      )
+   )
+)
 pushd ..\issues-gh-pages
+call git add lwg-toc.txt
+for %%f in (*.html.gz *.html.br) do call git add "%%f"
+for %%d in (issues sections) do if exist %%d call git add %%d
 call git commit -a -m"Update"
 call git push  "origin" gh-pages:gh-pages
 popd
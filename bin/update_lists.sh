@@ -4,10 +4,32 @@
 pushd ../issues-gh-pages
 git pull
 popd
-cp -f mailing/lwg-*.html ../issues-gh-pages
-cp -f mailing/unresolved-*.html ../issues-gh-pages
-cp -f mailing/votable-*.html ../issues-gh-pages
+# Copy only the documents that changed, so that unchanged pages keep their timestamps,
+# with the siblings made by 'lists --gzip' or 'lists --brotli'
+for f in mailing/lwg-*.html mailing/lwg-toc.txt mailing/unresolved-*.html mailing/votable-*.html \
+         mailing/lwg-*.html.gz mailing/unresolved-*.html.gz mailing/votable-*.html.gz \
+         mailing/lwg-*.html.br mailing/unresolved-*.html.br mailing/votable-*.html.br ; do
+   [ -e "$f" ] || continue
+   cmp -s "$f" "../issues-gh-pages/${f#mailing/}" || cp -f "$f" ../issues-gh-pages
+done
+# Pages for single issues and sections, made by 'lists --issue-pages'
+for d in issues sections ; do
+   if [ -d mailing/$d ] ; then
+      mkdir -p ../issues-gh-pages/$d
+      for f in mailing/$d/*.html mailing/$d/*.html.gz mailing/$d/*.html.br ; do
+         [ -e "$f" ] || continue
+         cmp -s "$f" "../issues-gh-pages/${f#mailing/}" || cp -f "$f" ../issues-gh-pages/$d
+      done
+   fi
+done
 pushd ../issues-gh-pages
+git add lwg-toc.txt
+for f in *.html.gz *.html.br ; do
+   if [ -e "$f" ] ; then git add "$f" ; fi
+done
+for d in issues sections ; do
+   if [ -d $d ] ; then git add $d ; fi
+done
 git commit -a -m"Update"
 git push  "origin" gh-pages:gh-pages
 popd
@@ -1,4 +1,6 @@
-while read issue_number           
-do           
-    bin/set_status $issue_number $1         
-done
+# Reads issue numbers from standard input, one per line, and moves them all
+# to the status given as the first argument in a single batch.
+while read issue_number
+do
+    echo "$issue_number $1"
+done | bin/set_status --batch
@@ -0,0 +1,175 @@
+#include "allocation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> bytes_requested{0};
+
+std::atomic<unsigned> arena_scopes{0};               // number of enabled 'arena_scope's alive, on any thread
+
+
+// The arena is a list of chunks, each obtained from 'malloc' and never freed.  Chunks are only ever
+// appended, and a chunk is published by incrementing 'chunk_count', so that 'operator delete' can test
+// whether a pointer lies in the arena without taking the lock.  The lowest and highest addresses of any
+// chunk let it reject most heap pointers without looking at the chunks at all.
+struct arena_chunk {
+   std::uintptr_t  first;
+   std::uintptr_t  last;
+};
+
+constexpr std::size_t max_chunks{48};
+constexpr std::size_t first_chunk_size{std::size_t{1} << 20};
+constexpr unsigned    max_chunk_growth{6};           // chunks grow to at most 64 times the first chunk
+constexpr std::size_t arena_alignment{alignof(std::max_align_t)};
+
+arena_chunk                  chunks[max_chunks];
+std::atomic<std::size_t>     chunk_count{0};
+std::atomic<std::size_t>     reserved_bytes{0};
+std::atomic<std::uintptr_t>  arena_low{UINTPTR_MAX};
+std::atomic<std::uintptr_t>  arena_high{0};
+
+std::mutex   arena_mutex;                            // guards the two pointers below, and adding chunks
+char *       arena_next{nullptr};
+char *       arena_end{nullptr};
+
+// Each thread carves its small allocations from a block of its own, taken from the shared arena, so that
+// only taking a new block needs the lock.
+constexpr std::size_t thread_block_size{std::size_t{64} << 10};
+constexpr std::size_t max_thread_allocation{thread_block_size / 8};
+
+thread_local char *  thread_next{nullptr};
+thread_local char *  thread_end{nullptr};
+
+auto arena_owns(void * p) noexcept -> bool {
+   auto const address = reinterpret_cast<std::uintptr_t>(p);
+   if (address < arena_low.load(std::memory_order_relaxed)  or  arena_high.load(std::memory_order_relaxed) <= address) {
+      return false;
+   }
+   auto const n = chunk_count.load(std::memory_order_acquire);
+   for (std::size_t i{0}; i != n; ++i) {
+      if (chunks[i].first <= address  and  address < chunks[i].last) {
+         return true;
+      }
+   }
+   return false;
+}
+
+auto shared_allocate(std::size_t size) noexcept -> void * {
+   // Return 'size' bytes, a multiple of 'arena_alignment', from the shared end of the arena, or a null
+   // pointer if no more chunks can be obtained.
+   std::lock_guard<std::mutex> lock{arena_mutex};
+   if (static_cast<std::size_t>(arena_end - arena_next) < size) {
+      auto const n = chunk_count.load(std::memory_order_relaxed);
+      if (n == max_chunks) {
+         return nullptr;
+      }
+      auto const chunk_size = std::max(first_chunk_size << std::min<std::size_t>(n, max_chunk_growth), size);
+      auto const chunk = static_cast<char *>(std::malloc(chunk_size));
+      if (!chunk) {
+         return nullptr;
+      }
+      chunks[n] = arena_chunk{reinterpret_cast<std::uintptr_t>(chunk), reinterpret_cast<std::uintptr_t>(chunk + chunk_size)};
+      arena_low.store(std::min(arena_low.load(std::memory_order_relaxed), chunks[n].first), std::memory_order_relaxed);
+      arena_high.store(std::max(arena_high.load(std::memory_order_relaxed), chunks[n].last), std::memory_order_relaxed);
+      chunk_count.store(n + 1, std::memory_order_release);
+      reserved_bytes.fetch_add(chunk_size, std::memory_order_relaxed);
+      arena_next = chunk;
+      arena_end = chunk + chunk_size;
+   }
+
+   auto const result = arena_next;
+   arena_next += size;
+   return result;
+}
+
+auto arena_allocate(std::size_t size) noexcept -> void * {
+   // Return 'size' bytes from the arena, or a null pointer if no more chunks can be obtained.
+   size = (size + arena_alignment - 1) / arena_alignment * arena_alignment;
+   if (static_cast<std::size_t>(thread_end - thread_next) < size) {
+      if (size > max_thread_allocation) {
+         return shared_allocate(size);
+      }
+      auto const block = static_cast<char *>(shared_allocate(thread_block_size));
+      if (!block) {
+         return nullptr;
+      }
+      thread_next = block;
+      thread_end = block + thread_block_size;
+   }
+
+   auto const result = thread_next;
+   thread_next += size;
+   return result;
+}
+
+} // close unnamed namespace
+
+
+// The array and nothrow forms of 'operator new' and 'operator delete' forward to these two.
+void * operator new(std::size_t size) {
+   allocations.fetch_add(1, std::memory_order_relaxed);
+   bytes_requested.fetch_add(size, std::memory_order_relaxed);
+   if (size == 0) {
+      size = 1;
+   }
+   if (arena_scopes.load(std::memory_order_relaxed) != 0) {
+      if (void * p = arena_allocate(size)) {
+         return p;
+      }
+   }
+   while (true) {
+      if (void * p = std::malloc(size)) {
+         return p;
+      }
+      auto handler = std::get_new_handler();
+      if (!handler) {
+         throw std::bad_alloc{};
+      }
+      handler();
+   }
+}
+
+void operator delete(void * p) noexcept {
+   if (!arena_owns(p)) {
+      std::free(p);
+   }
+}
+
+
+namespace lwg
+{
+
+auto allocation_count() noexcept -> std::size_t {
+   return allocations.load(std::memory_order_relaxed);
+}
+
+auto allocated_bytes() noexcept -> std::size_t {
+   return bytes_requested.load(std::memory_order_relaxed);
+}
+
+auto arena_reserved_bytes() noexcept -> std::size_t {
+   return reserved_bytes.load(std::memory_order_relaxed);
+}
+
+arena_scope::arena_scope(bool enabled) noexcept
+   : enabled_{enabled}
+   {
+   if (enabled_) {
+      arena_scopes.fetch_add(1, std::memory_order_relaxed);
+   }
+}
+
+arena_scope::~arena_scope() {
+   if (enabled_) {
+      arena_scopes.fetch_sub(1, std::memory_order_relaxed);
+   }
+}
+
+} // close namespace lwg
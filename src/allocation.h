@@ -0,0 +1,49 @@
+#ifndef INCLUDE_LWG_ALLOCATION_H
+#define INCLUDE_LWG_ALLOCATION_H
+
+// Linking 'allocation.cpp' replaces the global 'operator new' and 'operator delete', to count every
+// allocation, and to let the program carve its allocations from a monotonic arena.
+//
+// The issue database is a few hundred thousand small strings that are built together and die together
+// at exit, so 'lists --arena' reads and formats the issues in the arena: the strings are bump-allocated
+// where they are made, and destroying the issues frees nothing.  The arena never reclaims the temporaries
+// made alongside them, so it is not used by default: on large corpora its peak memory exceeds the heap's.
+// Until an arena is first used, 'operator delete' rejects every pointer by a single address comparison.
+
+#include <cstddef>
+
+namespace lwg
+{
+
+auto allocation_count() noexcept -> std::size_t;
+   // Number of calls to the global 'operator new' so far, including those served by the arena.
+
+auto allocated_bytes() noexcept -> std::size_t;
+   // Total bytes requested from the global 'operator new' so far.
+
+auto arena_reserved_bytes() noexcept -> std::size_t;
+   // Total size of the chunks obtained for the arena so far.
+
+class arena_scope {
+public:
+   explicit arena_scope(bool enabled = true) noexcept;
+      // While an enabled 'arena_scope' is alive, every global allocation, on any thread, is served by
+      // the process-wide monotonic arena, so that the worker threads of a 'parallel_for' within the
+      // scope build into the arena too.  Each thread bump-allocates from a block of its own, and takes
+      // the arena's lock only for a new block.  Scopes may nest.
+
+   ~arena_scope();
+
+   arena_scope(arena_scope const &) = delete;
+   arena_scope & operator=(arena_scope const &) = delete;
+
+private:
+   bool enabled_;
+};
+   // Deleting arena memory, from any thread and at any time, does nothing.  The arena is never
+   // released, so its memory is not reused until the program exits, and anything built in it should
+   // live for most of the program anyway.  Allocations fall back to 'malloc' if the arena is exhausted.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_ALLOCATION_H
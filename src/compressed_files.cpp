@@ -0,0 +1,148 @@
+#include "compressed_files.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <zlib.h>
+
+// platform headers
+#include <sys/stat.h>
+#include <sys/types.h>
+#if defined(_WIN32)
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include "parallel.h"
+
+#if defined(LWG_WITH_BROTLI)
+#include <brotli/encode.h>
+#endif
+
+namespace {
+
+auto read_file(std::string const & filename) -> std::string {
+   std::ifstream infile{filename, std::ios::in | std::ios::binary};
+   if (!infile.is_open()) {
+      throw std::runtime_error{"Unable to open file " + filename};
+   }
+
+   std::istreambuf_iterator<char> first{infile}, last{};
+   return std::string {first, last};
+}
+
+void write_file(std::string const & filename, std::string const & contents) {
+   std::ofstream out{filename, std::ios::out | std::ios::binary};
+   if (!out.write(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+      throw std::runtime_error{"Failed to write " + filename};
+   }
+}
+
+auto gzip(std::string const & filename, std::string const & contents) -> std::string {
+   // A window of 15 bits, plus 16, asks zlib for a gzip header and trailer rather than a zlib one.  The
+   // header records no file name or time, so compressing the same document always gives the same bytes.
+   z_stream stream{};
+   if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+      throw std::runtime_error{"Unable to start gzip compression of " + filename};
+   }
+
+   std::string compressed(deflateBound(&stream, static_cast<uLong>(contents.size())), '\0');
+   stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(contents.data()));
+   stream.avail_in = static_cast<uInt>(contents.size());
+   stream.next_out = reinterpret_cast<Bytef *>(&compressed[0]);
+   stream.avail_out = static_cast<uInt>(compressed.size());
+   auto const result = deflate(&stream, Z_FINISH);
+   compressed.resize(stream.total_out);
+   deflateEnd(&stream);
+
+   if (result != Z_STREAM_END) {
+      throw std::runtime_error{"Unable to gzip " + filename};
+   }
+   return compressed;
+}
+
+#if defined(LWG_WITH_BROTLI)
+auto brotli(std::string const & filename, std::string const & contents) -> std::string {
+   std::string compressed(BrotliEncoderMaxCompressedSize(contents.size()), '\0');
+   std::size_t size{compressed.size()};
+   if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                              contents.size(), reinterpret_cast<std::uint8_t const *>(contents.data()),
+                              &size, reinterpret_cast<std::uint8_t *>(&compressed[0]))) {
+      throw std::runtime_error{"Unable to brotli compress " + filename};
+   }
+   compressed.resize(size);
+   return compressed;
+}
+#endif
+
+auto modification_time(std::string const & filename, std::time_t & mtime) -> bool {
+   struct stat sb;
+   if (stat(filename.c_str(), &sb) != 0) {
+      return false;
+   }
+   mtime = sb.st_mtime;
+   return true;
+}
+
+void stamp_sibling(std::string const & sibling, std::time_t mtime) {
+   // Give 'sibling' the modification time of the document it was compressed from, so that any other time
+   // shows that the document has changed since
+   utimbuf times;
+   times.actime = mtime;
+   times.modtime = mtime;
+   if (utime(sibling.c_str(), &times) != 0) {
+      throw std::runtime_error{"Unable to set the modification time of " + sibling};
+   }
+}
+
+void compress_file(std::string const & filename, lwg::compression_formats formats) {
+   std::time_t mtime;
+   if (!modification_time(filename, mtime)) {
+      throw std::runtime_error{"Unable to stat file " + filename};
+   }
+   auto const contents = read_file(filename);
+   if (formats.gzip) {
+      write_file(filename + ".gz", gzip(filename, contents));
+      stamp_sibling(filename + ".gz", mtime);
+   }
+#if defined(LWG_WITH_BROTLI)
+   if (formats.brotli) {
+      write_file(filename + ".br", brotli(filename, contents));
+      stamp_sibling(filename + ".br", mtime);
+   }
+#endif
+}
+
+} // close unnamed namespace
+
+
+auto lwg::brotli_is_available() noexcept -> bool {
+#if defined(LWG_WITH_BROTLI)
+   return true;
+#else
+   return false;
+#endif
+}
+
+
+auto lwg::siblings_are_current(std::string const & filename, compression_formats formats) -> bool {
+   std::time_t document;
+   if (!modification_time(filename, document)) {
+      return false;
+   }
+   std::time_t sibling;
+   return (!formats.gzip   or (modification_time(filename + ".gz", sibling)  and  sibling == document))
+      and (!formats.brotli or (modification_time(filename + ".br", sibling)  and  sibling == document));
+}
+
+
+void lwg::write_compressed_siblings(std::vector<std::string> const & filenames, compression_formats formats) {
+   if (formats.brotli and !brotli_is_available()) {
+      throw std::runtime_error{"brotli compression requested, but this program was built without LWG_WITH_BROTLI"};
+   }
+
+   parallel_for(filenames.size(), [&](std::size_t i) { compress_file(filenames[i], formats); });
+}
@@ -0,0 +1,40 @@
+#ifndef INCLUDE_LWG_COMPRESSED_FILES_H
+#define INCLUDE_LWG_COMPRESSED_FILES_H
+
+// Precompressed copies of the published documents, so that a static web host can serve 'lwg-active.html.gz'
+// in place of 'lwg-active.html' to a browser that accepts it, without compressing on every request.
+//
+// Gzip compression requires zlib ('-lz').  Brotli compression is compiled in only when 'LWG_WITH_BROTLI' is
+// defined, and then requires the brotli encoder library ('-lbrotlienc').
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace lwg
+{
+
+struct compression_formats {
+   bool gzip   = false;  // write 'FILE.gz' beside 'FILE'
+   bool brotli = false;  // write 'FILE.br' beside 'FILE'
+
+   auto any() const noexcept -> bool { return gzip or brotli; }
+};
+
+auto brotli_is_available() noexcept -> bool;
+   // Return 'true' if this program was built with brotli support.
+
+void write_compressed_siblings(std::vector<std::string> const & filenames, compression_formats formats);
+   // Write a compressed copy of each of 'filenames' in every requested format, beside the original, at the
+   // highest compression level, and give each copy the modification time of its original.  The files are
+   // compressed concurrently, one per thread.  Throws 'runtime_error' if any file cannot be read or
+   // written, or if brotli is requested but not available.
+
+auto siblings_are_current(std::string const & filename, compression_formats formats) -> bool;
+   // Return 'true' if every requested compressed sibling of 'filename' exists and has the modification
+   // time of 'filename', as 'write_compressed_siblings' leaves it.  A sibling left from an older version
+   // of the document, or written by anything else, is not current.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_COMPRESSED_FILES_H
@@ -2,6 +2,7 @@
 
 #include "date.h"
 #include <time.h>
+#include <type_traits>
 
 namespace gregorian
 {
@@ -21,14 +22,77 @@ const detail::spec last;
 const detail::spec first;
 
 
-date::date() {
-    time_t systime;
-    time(&systime);
-    struct tm* now = std::localtime(&systime);
-    year_ = (unsigned short)(now->tm_year+1900);
-    month_ = (unsigned char)(now->tm_mon+1);
-    day_ = (unsigned char)(now->tm_mday);
-    fix_from_ymd();
+// Day numbers count from 1 on 1 January of year 0 in the Julian calendar, which is followed until 4 October
+// 1582; the next day is 15 October 1582 in the Gregorian calendar.  The conversions below use the closed
+// forms of Howard Hinnant's 'days_from_civil' and 'civil_from_days', counting days from 1 March of year 0
+// in either calendar, so that any leap day falls at the end of a year.
+
+static constexpr unsigned long gregorian_start{578104};  // day number of 15 October 1582
+static constexpr long julian_offset{61};                  // day number of 1 March 0 (Julian)
+static constexpr long gregorian_offset{63};               // day number of 1 March 0 (proleptic Gregorian)
+
+struct civil {
+    int y;
+    int m;
+    int d;
+};
+
+static auto day_of_march_year(int m, int d) noexcept -> int {
+    // Return the day of the year, counting from 0 on 1 March.
+    return (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+}
+
+static auto days_from_julian(int y, int m, int d) noexcept -> long {
+    y -= m <= 2;
+    long const era = (y >= 0 ? y : y - 3) / 4;
+    long const yoe = y - era * 4;                                   // [0, 3]
+    return era * 1461 + yoe * 365 + day_of_march_year(m, d);
+}
+
+static auto days_from_gregorian(int y, int m, int d) noexcept -> long {
+    y -= m <= 2;
+    long const era = (y >= 0 ? y : y - 399) / 400;
+    long const yoe = y - era * 400;                                 // [0, 399]
+    return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + day_of_march_year(m, d);
+}
+
+static auto civil_from_day_of_era(long era_years, long doe, long yoe) noexcept -> civil {
+    int const doy = static_cast<int>(doe - (365 * yoe + yoe / 4 - yoe / 100));   // [0, 365]
+    int const mp = (5 * doy + 2) / 153;                                           // [0, 11]
+    int const d = doy - (153 * mp + 2) / 5 + 1;                                   // [1, 31]
+    int const m = mp < 10 ? mp + 3 : mp - 9;                                      // [1, 12]
+    return civil{static_cast<int>(era_years + yoe + (m <= 2)), m, d};
+}
+
+static auto julian_from_days(long z) noexcept -> civil {
+    long const era = (z >= 0 ? z : z - 1460) / 1461;
+    long const doe = z - era * 1461;                                // [0, 1460]
+    long const yoe = (doe - doe / 1460) / 365;                      // [0, 3]
+    return civil_from_day_of_era(era * 4, doe, yoe);               // 'yoe < 4', so has no leap-day terms
+}
+
+static auto gregorian_from_days(long z) noexcept -> civil {
+    long const era = (z >= 0 ? z : z - 146096) / 146097;
+    long const doe = z - era * 146097;                                              // [0, 146096]
+    long const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;        // [0, 399]
+    return civil_from_day_of_era(era * 400, doe, yoe);
+}
+
+
+static_assert(std::is_trivial<date>::value, "issues hold many dates, so they must be free to construct");
+
+auto date::today() -> date {
+    return from_time(time(nullptr));
+}
+
+auto date::from_time(std::time_t t) -> date {
+    struct tm local;
+#if defined(_WIN32)
+    localtime_s(&local, &t);
+#else
+    localtime_r(&t, &local);
+#endif
+    return gregorian::day(local.tm_mday) / (local.tm_mon+1) / (local.tm_year+1900);
 }
 
 date::date(detail::day_month_spec dm, gregorian::year y)
@@ -171,46 +235,13 @@ void date::fix_from_ymd() {
       throw bad_date{};
    }
 
-   if (y > 0) {
-      jdate = 365U * y + 1;   // Jan 1, 0 == 1  and  y 0 is leap y
-      --y;
-      jdate += y / 4;
-      if (y >= 1700) {
-         jdate += -(y-1600) / 100 + (y-1600) / 400;
-      }
-      ++y;
-   }
-
-   for (int i = 0; i < m-1; ++i) {
-      jdate += date_lastDay_s[i];
-   }
-   if (leap  and  m > 2) {
-      ++jdate;
+   if (y < 1582  or  (y == 1582  and  (m < 10  or  (m == 10  and  d < 15)))) {
+      jdate = days_from_julian(y, m, d) + julian_offset;
    }
-   jdate += d;
-   //  If date >= 10/15/1582 then subtract 10
-   if (jdate >= 578114) {
-      jdate -= 10;
+   else {
+      jdate = days_from_gregorian(y, m, d) + gregorian_offset;
    }
 
-//  if (y >= 1582) {
-//      if (y == 1582) {
-//          if (m >= 10) {
-//              if (m == 10) {
-//                  if (d >= 15) {
-//                      jdate -= 10;
-//                  }
-//              }
-//              else {      // m > 10
-//                  jdate -= 10;
-//              }
-//          }
-//      }
-//      else {      // y > 1582
-//          jdate -= 10;
-//      }
-//  }
-
    if (jdate <= 0) {
       throw bad_date{};
    }
@@ -228,48 +259,12 @@ void date::fix_from_jdate() {
       throw bad_date{};
    }
 
-   int dow, n;
-   decode(dow, n);
-   year_ = static_cast<unsigned short>(jdate_ / 365.2475);
-   date lower = gregorian::day(1) / 1 / year_;
-   date upper = gregorian::day(31) / 12 / year_;
-   for(;;) {
-      if (lower.jdate_ > jdate_) {
-         --year_;
-      }
-      else if (upper.jdate_ < jdate_) {
-         ++year_;
-      }
-      else {
-      break;
-         }
-      lower = gregorian::day(1) / 1 / year_;
-      upper = gregorian::day(31) / 12 / year_;
-   }
-
-   month_ = static_cast<unsigned char>((jdate_ - lower.jdate_) / 30 + 1);
-   if (month_ > 12) {
-      month_ = 12;
-   }
-
-   for(;;) {
-      lower = gregorian::day(1) / month_ / year_;
-      upper = gregorian::last / month_ / year_;
-      if (lower.jdate_ > jdate_) {
-         --month_;
-      }
-      else if (upper.jdate_ < jdate_) {
-         ++month_;
-      }
-      else {
-         break;
-      }
-   }
-
-   day_ = static_cast<unsigned char>(jdate_ - lower.jdate_ + 1);
-   if (year_ == 1582  and  month_ == 10  and  day_ >= 5) {
-      day_ += 10;
-   }
+   civil const c = (jdate_ < gregorian_start)
+                 ? julian_from_days(static_cast<long>(jdate_) - julian_offset)
+                 : gregorian_from_days(static_cast<long>(jdate_) - gregorian_offset);
+   year_ = static_cast<unsigned short>(c.y);
+   month_ = static_cast<unsigned char>(c.m);
+   day_ = static_cast<unsigned char>(c.d);
 }
 
 
@@ -152,7 +152,16 @@ date operator+(date const &, month);
 date operator+(date const &, year);
 
 struct date {
-    date();
+    date() = default;
+       // Trivial, so a default-initialized date has an indeterminate value.  A value-initialized
+       // 'date{}' is not a valid date, and compares less than every valid date.
+
+    static auto today() -> date;
+       // Return the current date in the local time zone.  Safe to call from multiple threads.
+
+    static auto from_time(std::time_t t) -> date;
+       // Return the date of the time 't' in the local time zone.  Safe to call from multiple threads.
+
     date(detail::day_month_spec dm, gregorian::year y);
     date(gregorian::day d, detail::month_year_spec my);
 
@@ -0,0 +1,132 @@
+#include "issue_directory.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+// platform headers - requires a Posix compatible platform
+// Windows lacks the '*at' functions, so falls back on a path for each file
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace {
+
+auto is_issue_file_name(char const * name) noexcept -> bool {
+   // Match the pattern 'issue*.xml'
+   auto const length = std::strlen(name);
+   return length >= 9
+      and 0 == std::strncmp(name, "issue", 5)
+      and 0 == std::strcmp(name + length - 4, ".xml");
+}
+
+void convert_modification_times(std::vector<lwg::issue_file> & files) {
+   // Converting a time to a local date consults the time zone rules, so convert each distinct time once.
+   // Files checked out or copied together share a handful of timestamps between them.
+   std::vector<std::time_t> times;
+   times.reserve(files.size());
+   for (auto const & file : files) {
+      times.push_back(file.mtime);
+   }
+   std::sort(times.begin(), times.end());
+   times.erase(std::unique(times.begin(), times.end()), times.end());
+
+   std::vector<gregorian::date> dates;
+   dates.reserve(times.size());
+   for (auto t : times) {
+      dates.push_back(gregorian::date::from_time(t));
+   }
+
+   for (auto & file : files) {
+      file.mod_date = dates[std::lower_bound(times.begin(), times.end(), file.mtime) - times.begin()];
+   }
+}
+
+} // close unnamed namespace
+
+
+lwg::issue_directory::issue_directory(std::string const & path)
+   : path_{path}
+   , dir_{opendir(path.c_str()), closedir}
+   , files_{}
+   {
+   if (!dir_) {
+      throw std::runtime_error{"Unable to open issues dir " + path};
+   }
+
+   while ( dirent* entry = readdir(dir_.get()) ) {
+      if (!is_issue_file_name(entry->d_name)) {
+         continue;
+      }
+#if defined(DT_REG)
+      // Skip directories and the like without a system call.  Links, and file systems that do not
+      // report a type, are resolved by the 'stat' below.
+      if (entry->d_type != DT_REG  and  entry->d_type != DT_LNK  and  entry->d_type != DT_UNKNOWN) {
+         continue;
+      }
+#endif
+
+      struct stat sb;
+#if defined(_WIN32)
+      int const result = stat((path_ + entry->d_name).c_str(), &sb);
+#else
+      int const result = fstatat(dirfd(dir_.get()), entry->d_name, &sb, 0);
+#endif
+      if (result != 0) {
+         throw std::runtime_error{"call to stat failed for " + path_ + entry->d_name};
+      }
+      if (S_ISREG(sb.st_mode)) {
+         files_.push_back(issue_file{entry->d_name, static_cast<std::size_t>(sb.st_size), sb.st_mtime, gregorian::date{}});
+      }
+   }
+
+   convert_modification_times(files_);
+}
+
+
+auto lwg::issue_directory::read(issue_file const & file) const -> std::string {
+#if defined(_WIN32)
+   // Read in text mode, as the issues have always been read, so that no carriage return reaches the parser
+   std::ifstream infile{path_ + file.name};
+   if (!infile.is_open()) {
+      throw std::runtime_error{"Unable to open file " + path_ + file.name};
+   }
+
+   std::istreambuf_iterator<char> first{infile}, last{};
+   return std::string {first, last};
+#else
+   int const fd = openat(dirfd(dir_.get()), file.name.c_str(), O_RDONLY | O_CLOEXEC);
+   if (fd < 0) {
+      throw std::runtime_error{"Unable to open file " + path_ + file.name};
+   }
+
+   // The size is known from the scan, so a single 'read' normally fills the whole string
+   std::string contents(file.size, '\0');
+   std::size_t filled{0};
+   while (filled < contents.size()) {
+      auto const n = ::read(fd, &contents[filled], contents.size() - filled);
+      if (n < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         close(fd);
+         throw std::runtime_error{"Unable to read file " + path_ + file.name};
+      }
+      if (n == 0) {
+         break;
+      }
+      filled += static_cast<std::size_t>(n);
+   }
+   close(fd);
+
+   contents.resize(filled);
+   return contents;
+#endif
+}
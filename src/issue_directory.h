@@ -0,0 +1,56 @@
+#ifndef INCLUDE_LWG_ISSUE_DIRECTORY_H
+#define INCLUDE_LWG_ISSUE_DIRECTORY_H
+
+// The directory of issue files, scanned once with the fewest system calls that the platform allows:
+// one directory read, one 'fstatat' per issue file, and then 'openat', 'read' and 'close' to load it.
+// Every name is resolved relative to the open directory, so no full path is built for any file.
+
+#include <cstddef>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+#include "date.h"
+
+namespace lwg
+{
+
+struct issue_file {
+   std::string      name;      // file name, within the directory
+   std::size_t      size;      // size in bytes when scanned
+   std::time_t      mtime;     // time of last modification
+   gregorian::date  mod_date;  // date of last modification, in the local time zone
+};
+
+class issue_directory {
+public:
+   explicit issue_directory(std::string const & path);
+      // Scan the directory 'path', which must end with a '/', for regular files named 'issue*.xml',
+      // and record their sizes and modification dates.  Directory entries are filtered by the type
+      // that 'readdir' reports, where available, before any file is examined.  Throws 'runtime_error'
+      // if the directory cannot be read.
+
+   auto path() const noexcept -> std::string const & { return path_; }
+
+   auto files() const & noexcept -> std::vector<issue_file> const & { return files_; }
+      // Every issue file found, in directory order.
+
+   auto files() const && -> std::vector<issue_file> const & = delete;
+      // The files of a temporary directory would dangle before a range-for over them began, so name the
+      // 'issue_directory' instead.
+
+   auto read(issue_file const & file) const -> std::string;
+      // Return the contents of 'file'.  Throws 'runtime_error' if it cannot be read.
+
+private:
+   std::string                           path_;
+   std::unique_ptr<DIR, int(&)(DIR*)>    dir_;
+   std::vector<issue_file>               files_;
+};
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_ISSUE_DIRECTORY_H
@@ -0,0 +1,285 @@
+#include "issue_export.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#include "issues.h"
+#include "sections.h"
+
+namespace {
+
+class buffered_writer {
+   // Collects output in a string, handing it to the stream only when a block is full.  Formatting each
+   // field straight into the stream would pay for a sentry, and a virtual call, on every insertion.
+public:
+   explicit buffered_writer(std::ostream & out)
+      : out_(out)
+      , buffer_{}
+      {
+      buffer_.reserve(block_size + block_size / 4);
+   }
+
+   void put(char c) { buffer_ += c; }
+   void put(char const * text) { buffer_ += text; }
+   void put(std::string const & text) { buffer_ += text; }
+   void put(char const * first, char const * last) { buffer_.append(first, last); }
+
+   void put_number(int value) {
+      char digits[16];
+      char * p = digits + sizeof digits;
+      unsigned n = value < 0 ? 0u - static_cast<unsigned>(value) : static_cast<unsigned>(value);
+      do {
+         *--p = static_cast<char>('0' + n % 10);
+         n /= 10;
+      } while (n != 0);
+      if (value < 0) {
+         *--p = '-';
+      }
+      put(p, digits + sizeof digits);
+   }
+
+   void put_digits(int value, int width) {
+      // Write a non-negative 'value' with at least 'width' digits, padded with leading zeros
+      char digits[16];
+      char * p = digits + sizeof digits;
+      for (int i{0}; i < width  or  value != 0; ++i) {
+         *--p = static_cast<char>('0' + value % 10);
+         value /= 10;
+      }
+      put(p, digits + sizeof digits);
+   }
+
+   void end_record() {
+      if (buffer_.size() >= block_size) {
+         flush();
+      }
+   }
+
+   void flush() {
+      out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+      if (!out_) {
+         throw std::runtime_error{"Failed to write issues export"};
+      }
+      buffer_.clear();
+   }
+
+private:
+   static constexpr std::size_t block_size = 64 * 1024;
+
+   std::ostream & out_;
+   std::string    buffer_;
+};
+
+constexpr std::size_t buffered_writer::block_size;
+
+
+auto strip_brackets(lwg::section_tag const & tag) -> std::string {
+   // Section tags are stored as they are written in the issues, such as '[vector]'
+   if (tag.size() >= 2  and  tag.front() == '['  and  tag.back() == ']') {
+      return tag.substr(1, tag.size() - 2);
+   }
+   return tag;
+}
+
+auto duplicate_numbers(lwg::issue const & iss) -> std::vector<int> {
+   // Duplicates are stored as html anchors, '<a href="lwg-active.html#123">123</a>', sorted as strings
+   std::vector<int> result;
+   for (auto const & anchor : iss.duplicates) {
+      auto const hash = anchor.find('#');
+      if (hash != std::string::npos) {
+         result.push_back(std::atoi(anchor.c_str() + hash + 1));
+      }
+   }
+   std::sort(result.begin(), result.end());
+   return result;
+}
+
+void put_date(buffered_writer & out, gregorian::date const & d) {
+   out.put_digits(d.year(), 4);
+   out.put('-');
+   out.put_digits(d.month(), 2);
+   out.put('-');
+   out.put_digits(d.day(), 2);
+}
+
+
+// JSON Lines
+// ==========
+
+void put_json_string(buffered_writer & out, std::string const & text) {
+   // Copy each run of characters that needs no escape in one piece, escaping quotes, backslashes and the
+   // control characters between the runs.  Any other byte, including UTF-8 sequences, is copied as is.
+   static char const hex[] = "0123456789abcdef";
+
+   out.put('"');
+   auto run = text.data();
+   auto const last = text.data() + text.size();
+   for (auto p = run; p != last; ++p) {
+      auto const c = static_cast<unsigned char>(*p);
+      if (c >= 0x20  and  c != '"'  and  c != '\\') {
+         continue;
+      }
+
+      out.put(run, p);
+      run = p + 1;
+      switch (c) {
+         case '"'  : out.put("\\\"");  break;
+         case '\\' : out.put("\\\\");  break;
+         case '\n' : out.put("\\n");   break;
+         case '\r' : out.put("\\r");   break;
+         case '\t' : out.put("\\t");   break;
+         default   : {
+            char const escape[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+            out.put(escape, escape + sizeof escape);
+         }
+      }
+   }
+   out.put(run, last);
+   out.put('"');
+}
+
+void put_json_issue(buffered_writer & out, lwg::issue const & iss, lwg::section_index const & sections, bool include_text) {
+   out.put("{\"num\":");
+   out.put_number(iss.num);
+   out.put(",\"status\":");
+   put_json_string(out, iss.stat);
+   out.put(",\"title\":");
+   put_json_string(out, iss.title);
+
+   out.put(",\"sections\":[");
+   char const * sep{""};
+   for (auto const & tag : iss.tags) {
+      out.put(sep);
+      out.put("{\"tag\":");
+      put_json_string(out, strip_brackets(tag));
+      out.put(",\"number\":");
+      put_json_string(out, sections.label(tag));
+      out.put('}');
+      sep = ",";
+   }
+
+   out.put("],\"submitter\":");
+   put_json_string(out, iss.submitter);
+   out.put(",\"date\":\"");
+   put_date(out, iss.date);
+   out.put("\",\"mod_date\":\"");
+   put_date(out, iss.mod_date);
+   out.put("\",\"priority\":");
+   out.put_number(iss.priority);
+
+   out.put(",\"duplicates\":[");
+   sep = "";
+   for (auto num : duplicate_numbers(iss)) {
+      out.put(sep);
+      out.put_number(num);
+      sep = ",";
+   }
+
+   out.put("],\"has_resolution\":");
+   out.put(iss.has_resolution ? "true" : "false");
+   if (include_text) {
+      out.put(",\"text\":");
+      put_json_string(out, iss.text);
+   }
+   out.put("}\n");
+}
+
+
+// CSV
+// ===
+
+void put_csv_field(buffered_writer & out, std::string const & text) {
+   // Quote the field only if it holds a comma, quote or line break, doubling each quote within it
+   if (text.find_first_of(",\"\r\n") == std::string::npos) {
+      out.put(text);
+      return;
+   }
+
+   out.put('"');
+   auto run = text.data();
+   auto const last = text.data() + text.size();
+   for (auto p = run; p != last; ++p) {
+      if (*p == '"') {
+         out.put(run, p + 1);
+         run = p;
+      }
+   }
+   out.put(run, last);
+   out.put('"');
+}
+
+void put_csv_issue(buffered_writer & out, lwg::issue const & iss, lwg::section_index const & sections, bool include_text) {
+   out.put_number(iss.num);
+   out.put(',');
+   put_csv_field(out, iss.stat);
+   out.put(',');
+   put_csv_field(out, iss.title);
+   out.put(',');
+
+   // A section number may hold a space, after the prefix of a TS, so list items are separated by ';'
+   std::string tags;
+   std::string numbers;
+   for (auto const & tag : iss.tags) {
+      if (&tag != &iss.tags.front()) {
+         tags += ';';
+         numbers += ';';
+      }
+      tags += strip_brackets(tag);
+      numbers += sections.label(tag);
+   }
+   put_csv_field(out, tags);
+   out.put(',');
+   put_csv_field(out, numbers);
+   out.put(',');
+
+   put_csv_field(out, iss.submitter);
+   out.put(',');
+   put_date(out, iss.date);
+   out.put(',');
+   put_date(out, iss.mod_date);
+   out.put(',');
+   out.put_number(iss.priority);
+   out.put(',');
+
+   char const * sep{""};
+   for (auto num : duplicate_numbers(iss)) {
+      out.put(sep);
+      out.put_number(num);
+      sep = ";";
+   }
+
+   out.put(',');
+   out.put(iss.has_resolution ? "true" : "false");
+   if (include_text) {
+      out.put(',');
+      put_csv_field(out, iss.text);
+   }
+   out.put("\r\n");
+}
+
+} // close unnamed namespace
+
+
+void lwg::write_issues_json_lines(std::ostream & out, std::vector<issue> const & issues, section_index const & sections, bool include_text) {
+   buffered_writer writer{out};
+   for (auto const & iss : issues) {
+      put_json_issue(writer, iss, sections, include_text);
+      writer.end_record();
+   }
+   writer.flush();
+}
+
+
+void lwg::write_issues_csv(std::ostream & out, std::vector<issue> const & issues, section_index const & sections, bool include_text) {
+   buffered_writer writer{out};
+   writer.put("num,status,title,section_tags,section_numbers,submitter,date,mod_date,priority,duplicates,has_resolution");
+   writer.put(include_text ? ",text\r\n" : "\r\n");
+   for (auto const & iss : issues) {
+      put_csv_issue(writer, iss, sections, include_text);
+      writer.end_record();
+   }
+   writer.flush();
+}
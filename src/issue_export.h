@@ -0,0 +1,35 @@
+#ifndef INCLUDE_LWG_ISSUE_EXPORT_H
+#define INCLUDE_LWG_ISSUE_EXPORT_H
+
+// Machine-readable exports of the whole issues list, for tools that would otherwise scrape 'lwg-toc.html'.
+// Each issue is written as one JSON object per line (JSON Lines), or as one CSV record, with the fields:
+//
+//    num, status, title, sections, submitter, date, mod_date, priority, duplicates, has_resolution [, text]
+//
+// Each section is exported as its tag, without brackets, and its resolved section number, such as 'vector'
+// and '23.3.11'.  Dates are written as 'YYYY-MM-DD', duplicates as issue numbers, and 'title' and 'text' as
+// the HTML that appears in the issues lists.  The formatted 'text' of each issue is much the largest field,
+// so is written only on request.  The issues are expected to have been through 'prepare_issues'.
+//
+// The CSV export follows RFC 4180: a header record, CRLF line endings, and any field holding a comma, a
+// quote or a line break quoted.  The list fields, 'section_tags', 'section_numbers' and 'duplicates', each
+// separate their items with a ';'.
+
+#include <iosfwd>
+#include <vector>
+
+namespace lwg
+{
+
+struct issue;
+class section_index;
+
+void write_issues_json_lines(std::ostream & out, std::vector<issue> const & issues, section_index const & sections, bool include_text = false);
+void write_issues_csv(std::ostream & out, std::vector<issue> const & issues, section_index const & sections, bool include_text = false);
+   // Write every issue in 'issues', in the order given, to 'out'.  The output is formatted into a buffer
+   // and written in large blocks, escaping each string in a single pass.  Throws 'runtime_error' if 'out'
+   // fails.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_ISSUE_EXPORT_H
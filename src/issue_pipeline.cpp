@@ -0,0 +1,471 @@
+#include "issue_pipeline.h"
+
+#include "issue_directory.h"
+#include "mailing_info.h"
+#include "markup_scan.h"
+#include "parallel.h"
+#include "sections.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace lwg
+{
+
+auto read_file_into_string(std::string const & filename) -> std::string {
+   // read a text file completely into memory, and return its contents as
+   // a 'string' for further manipulation.
+
+   std::ifstream infile{filename.c_str()};
+   if (!infile.is_open()) {
+      throw std::runtime_error{"Unable to open file " + filename};
+   }
+
+   std::istreambuf_iterator<char> first{infile}, last{};
+   return std::string {first, last};
+}
+
+// Issue-list specific functionality for the rest of this file
+// ===========================================================
+
+auto read_issues(std::string const & issues_path, lwg::section_map & section_db) -> std::vector<lwg::issue> {
+   // Scan the specified directory, 'issues_path', for the 'issue*.xml' files it
+   // contains, parsing each such file as an LWG issue document.  Return the set
+   // of issues as a vector.
+   //
+   // The directory is scanned once for the size and modification date of every
+   // issue file, so that no file is examined twice.
+
+   lwg::issue_directory const dir{issues_path};
+
+   std::vector<lwg::issue> issues{};
+   issues.reserve(dir.files().size());
+   for (auto const & file : dir.files()) {
+      issues.emplace_back(parse_issue_from_file(dir.read(file), issues_path + file.name, file.mod_date, section_db));
+   }
+
+   return issues;
+}
+
+
+// ============================================================================================================
+
+namespace {
+
+void walk_issue_markup(lwg::issue & is,
+                       bool rewrite,
+                       std::vector<lwg::issue>::const_iterator first_issue,
+                       std::vector<lwg::issue>::const_iterator last_issue,
+                       lwg::section_index const & section_db,
+                       std::vector<issue_reference> & references) {
+   // Reformt the issue text for the specified 'is' as valid HTML, replacing all the issue-list
+   // specific XML markup as appropriate:
+   //   tag             replacement
+   //   ---             ----------- 
+   //   iref            internal reference to another issue, replace with an anchor tag to that issue
+   //   sref            section-tag reference, replace with formatted tag and section-number
+   //   discussion      <p><b>Discussion:</b></p>CONTENTS
+   //   resolution      <p><b>Proposed resolution:</b></p>CONTENTS
+   //   rationale       <p><b>Rationale:</b></p>CONTENTS
+   //   duplicate       tags are erased, leaving just CONTENTS
+   //   note            <p><i>[NOTE CONTENTS]</i></p>
+   //   !--             comments are simply erased
+   //
+   // The resolution that the parser found, if any, is found again in the formatted text, and its new
+   // position recorded in 'is.resolution', so that it is formatted once, along with the rest of the text.
+   //
+   // In addition, every iref is recorded in 'references', and as duplicate issues are
+   // discovered, the duplicates are marked up in 'is' alone.  Other issues in the range
+   // [first_issue,last_issue) are only read, so that issues can be formatted concurrently.
+   // A reference to a section that is not in 'section_db' is given an empty section number.
+   //
+   // Unless 'rewrite' is 'true', the text is walked exactly as it would be reformatted, raising the same
+   // errors and recording the same references and duplicates, but is left as it is, along with
+   // 'is.resolution'.
+   //
+   // The behavior is undefined unless the issues in the supplied vector range are sorted by issue-number.
+   //
+   // Essentially, this function is a tiny xml-parser driven by a stack of open tags, that pops as tags
+   // are closed.
+
+   bool const find_resolution{rewrite  and  !is.resolution.empty()};
+   auto resolution_first = std::string::npos;
+   if (rewrite) {
+      is.resolution = lwg::text_span{};
+   }
+
+   auto fix_tags = [&](std::string &s) {
+   // Each '<' is found from the mask of the block that holds it, which stays valid until the text changes
+   lwg::markup_scanner open_angles{s, lwg::open_angle};
+
+   // Replace the 'count' characters at 'i' with 'replacement', if rewriting, and return the position of
+   // the last character replaced, from which the scan continues
+   auto substitute = [&s, &open_angles, rewrite](std::string::size_type i, std::string::size_type count, std::string const & replacement) {
+      count = std::min(count, s.size() - i);
+      if (!rewrite) {
+         return i + count - 1;
+      }
+      s.replace(i, count, replacement);
+      open_angles.reset();
+      return i + replacement.size() - 1;
+   };
+
+   int issue_num = is.num;     // current issue number for the issue being formatted
+   std::vector<std::string> tag_stack;   // stack of open XML tags as we parse
+   std::ostringstream er;      // stream to format error messages
+
+   // cannot rewrite as range-based for-loop as the string 's' is modified within the loop.  Each step
+   // skips straight to the next '<', scanning a block of text at a time.
+   for (auto i = open_angles.next(0); i < s.size(); i = open_angles.next(i + 1)) {
+      auto j = lwg::find_markup(s, i, lwg::close_angle);
+      if (j == std::string::npos) {
+         er.clear();
+         er.str("");
+         er << "missing '>' in issue " << issue_num;
+         throw std::runtime_error{er.str()};
+      }
+
+      // The tag name is the first word within the brackets, read in place rather than through a stream
+      std::string tag;
+      {
+         auto first = i + 1;
+         while (first < j  and  std::isspace(static_cast<unsigned char>(s[first]))) {
+            ++first;
+         }
+         auto last = first;
+         while (last < j  and  !std::isspace(static_cast<unsigned char>(s[last]))) {
+            ++last;
+         }
+         tag.assign(s, first, last - first);
+      }
+
+      if (tag.empty()) {
+          er.clear();
+          er.str("");
+          er << "unexpected <> in issue " << issue_num;
+          throw std::runtime_error{er.str()};
+      }
+
+      if (tag[0] == '/') { // closing tag
+          tag.erase(tag.begin());
+          if (tag == "issue"  or  tag == "revision") {
+             substitute(i, j-i + 1, "");
+             return;
+          }
+
+          if (tag_stack.empty()  or  tag != tag_stack.back()) {
+             er.clear();
+             er.str("");
+             er << "mismatched tags in issue " << issue_num;
+             if (tag_stack.empty()) {
+                er << ".  Had no open tag.";
+             }
+             else {
+                er << ".  Open tag was " << tag_stack.back() << ".";
+             }
+             er << "  Closing tag was " << tag;
+             throw std::runtime_error{er.str()};
+          }
+
+          tag_stack.pop_back();
+          if (tag == "discussion") {
+              i = substitute(i, j-i + 1, "");
+          }
+          else if (tag == "resolution") {
+              if (resolution_first != std::string::npos  and  is.resolution.last == 0) {
+                 is.resolution = lwg::text_span{resolution_first, i};
+              }
+              i = substitute(i, j-i + 1, "");
+          }
+          else if (tag == "rationale") {
+              i = substitute(i, j-i + 1, "");
+          }
+          else if (tag == "duplicate") {
+              i = substitute(i, j-i + 1, "");
+          }
+          else if (tag == "note") {
+              i = substitute(i, j-i + 1, "]</i></p>\n");
+          }
+          else {
+              i = j;
+          }
+
+          continue;
+      }
+
+      if (s[j-1] == '/') { // self-contained tag: sref, iref
+         if (tag == "sref") {
+            static const
+            auto report_missing_quote = [](std::ostringstream & er, unsigned num) {
+               er.clear();
+               er.str("");
+               er << "missing '\"' in sref in issue " << num;
+               throw std::runtime_error{er.str()};
+            };
+
+            std::string r;
+            auto k = lwg::find_markup(s, i+5, lwg::quote);
+            if (k >= j) {
+               report_missing_quote(er, issue_num);
+            }
+
+            auto l = lwg::find_markup(s, k+1, lwg::quote);
+            if (l >= j) {
+               report_missing_quote(er, issue_num);
+            }
+
+            ++k;
+            r = s.substr(k, l-k);
+            r.insert(0, section_db.label(r) + ' ');
+
+            i = substitute(i, j-i + 1, r);
+            continue;
+         }
+         else if (tag == "iref") {
+            static const
+            auto report_missing_quote = [](std::ostringstream & er, unsigned num) {
+               er.clear();
+               er.str("");
+               er << "missing '\"' in iref in issue " << num;
+               throw std::runtime_error{er.str()};
+            };
+
+            auto k = lwg::find_markup(s, i+5, lwg::quote);
+            if (k >= j) {
+               report_missing_quote(er, issue_num);
+            }
+            auto l = lwg::find_markup(s, k+1, lwg::quote);
+            if (l >= j) {
+               report_missing_quote(er, issue_num);
+            }
+
+            ++k;
+            std::string r{s.substr(k, l-k)};
+            std::istringstream temp{r};
+            int num;
+            temp >> num;
+            if (temp.fail()) {
+               er.clear();
+               er.str("");
+               er << "bad number in iref in issue " << issue_num;
+               throw std::runtime_error{er.str()};
+            }
+
+            auto n = std::lower_bound(first_issue, last_issue, num, lwg::order_by_issue_number{});
+            if (n == last_issue  or  n->num != num) {
+               er.clear();
+               er.str("");
+               er << "could not find issue " << num << " for iref in issue " << issue_num;
+               throw std::runtime_error{er.str()};
+            }
+
+            bool const duplicate{!tag_stack.empty()  and  tag_stack.back() == "duplicate"};
+            references.push_back(issue_reference{issue_num, num, duplicate});
+            if (duplicate) {
+               is.duplicates.insert(make_html_anchor(*n));
+               r.clear();
+            }
+            else {
+               r = make_html_anchor(*n);
+            }
+
+            i = substitute(i, j-i + 1, r);
+            continue;
+         }
+         i = j;
+         continue;  // don't worry about this <tag/>
+      }
+
+      tag_stack.push_back(tag);
+      if (tag == "discussion") {
+          i = substitute(i, j-i + 1, "<p><b>Discussion:</b></p>");
+      }
+      else if (tag == "resolution") {
+          i = substitute(i, j-i + 1, "<p><b>Proposed resolution:</b></p>");
+          if (find_resolution  and  resolution_first == std::string::npos) {
+             resolution_first = i + 1;
+          }
+      }
+      else if (tag == "rationale") {
+          i = substitute(i, j-i + 1, "<p><b>Rationale:</b></p>");
+      }
+      else if (tag == "duplicate") {
+          i = substitute(i, j-i + 1, "");
+      }
+      else if (tag == "note") {
+          i = substitute(i, j-i + 1, "<p><i>[");
+      }
+      else if (tag == "!--") {
+          tag_stack.pop_back();
+          j = s.find("-->", i);
+          j += 3;
+          i = substitute(i, j-i, "");
+      }
+      else {
+          i = j;
+      }
+   }
+   };
+
+   fix_tags(is.text);
+
+}
+
+} // close unnamed namespace
+
+void format_issue_as_html(lwg::issue & is,
+                          std::vector<lwg::issue>::const_iterator first_issue,
+                          std::vector<lwg::issue>::const_iterator last_issue,
+                          lwg::section_index const & section_db,
+                          std::vector<issue_reference> & references) {
+   walk_issue_markup(is, true, first_issue, last_issue, section_db, references);
+}
+
+
+auto check_issues(std::string const & issues_path, lwg::section_map const & section_db) -> std::vector<issue_diagnostic> {
+   lwg::issue_directory const dir{issues_path};
+   auto const & files = dir.files();
+
+   // Each problem is recorded against the file it was found in, so that the threads need share nothing
+   std::vector<std::vector<issue_diagnostic>> found(files.size());
+   auto diagnose = [&](std::size_t file, int num, char const * message) {
+      found[file].push_back(issue_diagnostic{files[file].name, num, message});
+   };
+
+   // Parse every file.  Each is parsed against a section map of its own, which collects a placeholder
+   // for every section it names, so that the parser never writes to a map that another thread reads.
+   // The parser rejects a status unknown to 'filename_for_status' along with any other fault in the file.
+   // A file that cannot be parsed is replaced by a placeholder issue, numbered from its file name, so that
+   // references to it from other issues still resolve.  The placeholder's status is only there to make
+   // those references into links, which are never written, and its empty text is not formatted.
+   std::vector<lwg::issue> parsed(files.size());
+   std::vector<lwg::section_map> sections_named(files.size());
+   std::vector<char> ok(files.size(), false);
+   parallel_for(files.size(), [&](std::size_t i) {
+      try {
+         parsed[i] = parse_issue_from_file(dir.read(files[i]), issues_path + files[i].name, files[i].mod_date, sections_named[i]);
+         ok[i] = true;
+      }
+      catch (std::exception const & ex) {
+         // Issue files are named 'issueNNNN.xml'
+         parsed[i] = lwg::issue{};
+         parsed[i].num = std::atoi(files[i].name.c_str() + 5);
+         parsed[i].stat = "New";
+         diagnose(i, parsed[i].num, ex.what());
+      }
+   });
+
+   // Order the issues by number, as formatting requires, noting any number used by more than one file
+   std::vector<std::size_t> origin(files.size());
+   for (std::size_t i{0}; i != files.size(); ++i) {
+      origin[i] = i;
+   }
+   std::sort(origin.begin(), origin.end(), [&](std::size_t x, std::size_t y) {
+      return parsed[x].num != parsed[y].num ? parsed[x].num < parsed[y].num : files[x].name < files[y].name;
+   });
+   for (std::size_t k{1}; k < origin.size(); ++k) {
+      if (parsed[origin[k]].num == parsed[origin[k-1]].num) {
+         diagnose(origin[k], parsed[origin[k]].num, ("issue number is also used by " + files[origin[k-1]].name).c_str());
+      }
+   }
+
+   std::vector<lwg::issue> issues;
+   issues.reserve(origin.size());
+   for (auto i : origin) {
+      issues.push_back(std::move(parsed[i]));
+   }
+
+   // The sections known to 'section_db' keep their numbers, and every other section named by an issue
+   // takes the placeholder that the parser gave it, just as 'read_issues' would leave them
+   lwg::section_map all_sections{section_db};
+   for (auto const & named : sections_named) {
+      all_sections.insert(named.begin(), named.end());
+   }
+   lwg::section_index const index{all_sections};
+
+   parallel_for(issues.size(), [&](std::size_t i) {
+      if (!ok[origin[i]]) {
+         return;
+      }
+      std::vector<issue_reference> references;
+      try {
+         format_issue_as_html(issues[i], issues.cbegin(), issues.cend(), index, references);
+      }
+      catch (std::exception const & ex) {
+         diagnose(origin[i], issues[i].num, ex.what());
+      }
+   });
+
+   std::vector<issue_diagnostic> diagnostics;
+   for (auto & file : found) {
+      std::move(file.begin(), file.end(), std::back_inserter(diagnostics));
+   }
+   std::stable_sort(diagnostics.begin(), diagnostics.end(), [](issue_diagnostic const & x, issue_diagnostic const & y) {
+      return x.num != y.num ? x.num < y.num : x.filename < y.filename;
+   });
+   return diagnostics;
+}
+
+
+auto prepare_issues(std::vector<lwg::issue> & issues, lwg::section_index const & section_db) -> reference_graph {
+   return prepare_issues(issues, section_db, [](lwg::issue const &) { return true; });
+}
+
+
+auto prepare_issues(std::vector<lwg::issue> & issues, lwg::section_index const & section_db, std::function<bool(lwg::issue const &)> const & needs_text) -> reference_graph {
+   // Initially sort the issues by issue number, so each issue can be correctly 'format'ted
+   sort(issues.begin(), issues.end(), lwg::order_by_issue_number{});
+
+   // Then we format the issues, which should be the last time we need to touch the issues themselves.
+   // Formatting an issue writes to that issue alone, and reads only the number and status of the issues
+   // it refers to, so every issue is formatted concurrently.  Each issue collects its own references, and
+   // its own error, so that both can be applied in issue order afterwards.  The markup of an issue whose
+   // text is not needed is walked just the same, but its text is left as parsed.
+   std::vector<std::vector<issue_reference>> references(issues.size());
+   std::vector<std::exception_ptr> failures(issues.size());
+   parallel_for(issues.size(), [&](std::size_t i) {
+      try {
+         walk_issue_markup(issues[i], needs_text(issues[i]), issues.cbegin(), issues.cend(), section_db, references[i]);
+      }
+      catch (...) {
+         failures[i] = std::current_exception();
+      }
+   });
+   for (auto const & failure : failures) {
+      if (failure) {
+         std::rethrow_exception(failure);
+      }
+   }
+
+   // Mark up the other side of each duplicate.  The duplicates are a sorted set, so the order in which
+   // they are added does not matter.
+   for (std::size_t i{0}; i != issues.size(); ++i) {
+      for (auto const & ref : references[i]) {
+         if (ref.duplicate) {
+            auto const to = std::lower_bound(issues.begin(), issues.end(), ref.to, lwg::order_by_issue_number{});
+            to->duplicates.insert(make_html_anchor(issues[i]));
+         }
+      }
+   }
+
+   // Issues will be routinely re-sorted in later code, but contents should be fixed after formatting.
+   // This suggests we may want to be storing some kind of issue handle in the functions that keep
+   // re-sorting issues, and so minimize the churn on the larger objects.
+
+   // Keep every reference, duplicate or not, for the "Referenced by" links of the published issues
+   std::vector<issue_reference> all_references;
+   for (auto const & from_issue : references) {
+      all_references.insert(all_references.end(), from_issue.begin(), from_issue.end());
+   }
+   return reference_graph{std::move(all_references)};
+}
+
+} // close namespace lwg
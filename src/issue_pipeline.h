@@ -0,0 +1,67 @@
+#ifndef INCLUDE_LWG_ISSUE_PIPELINE_H
+#define INCLUDE_LWG_ISSUE_PIPELINE_H
+
+// The stages that turn a directory of issue files into a sorted, formatted set of issues,
+// ready to be published by a 'report_generator'.
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "issues.h"
+#include "reference_graph.h"
+#include "sections.h"
+
+namespace lwg
+{
+
+auto read_file_into_string(std::string const & filename) -> std::string;
+   // Read a text file completely into memory, and return its contents as
+   // a 'string' for further manipulation.
+
+auto read_issues(std::string const & issues_path, section_map & section_db) -> std::vector<issue>;
+   // Parse every issue file in the directory 'issues_path', and return the issues in
+   // directory order.  Unknown sections are added to 'section_db'.
+
+void format_issue_as_html(issue & is,
+                          std::vector<issue>::const_iterator first_issue,
+                          std::vector<issue>::const_iterator last_issue,
+                          section_index const & section_db,
+                          std::vector<issue_reference> & references);
+   // Reformat the text of issue 'is' as valid HTML, and append every reference to another issue
+   // that it holds to 'references'.  The range [first_issue,last_issue) must be sorted by issue
+   // number.  Only 'is' is modified: a duplicate found in its text is added to 'is.duplicates',
+   // but the caller must add 'is' to the duplicates of the other issue, so that issues can be
+   // formatted concurrently.
+
+auto prepare_issues(std::vector<issue> & issues, section_index const & section_db) -> reference_graph;
+   // Sort 'issues' by issue number, format each of them as HTML, concurrently, and then mark
+   // up the duplicates that were found.  Return the graph of every reference between the issues.
+   // 'section_db' should be frozen from the index that 'read_issues' completed.  The result is
+   // the same as formatting the issues one by one, in order, and if any issue cannot be formatted,
+   // the error for the first such issue is thrown.
+
+auto prepare_issues(std::vector<issue> & issues, section_index const & section_db, std::function<bool(issue const &)> const & needs_text) -> reference_graph;
+   // As above, but formatting only the issues for which 'needs_text' returns 'true'.  The text of every
+   // other issue is left as parsed, but its markup is walked by the same parser without being rewritten,
+   // so that the duplicates of every issue, the returned graph, and any error thrown, are the same as if
+   // all were formatted.
+
+
+struct issue_diagnostic {
+   std::string  filename;  // name of the issue file, within the issues directory
+   int          num;       // number of the issue, taken from 'filename' if the file could not be parsed
+   std::string  message;   // description of the problem
+};
+
+auto check_issues(std::string const & issues_path, section_map const & section_db) -> std::vector<issue_diagnostic>;
+   // Parse and format every issue file in the directory 'issues_path', concurrently, as 'read_issues' and
+   // 'prepare_issues' would, and return a diagnostic for every problem found rather than stopping at the
+   // first: a file that cannot be parsed, including one whose status is unknown to 'filename_for_status',
+   // an issue number used by more than one file, and text that cannot be formatted.  An issue that cannot be
+   // parsed can still be referred to by the others without a diagnostic.  Nothing is written, and
+   // 'section_db' is not modified.  The diagnostics are ordered by issue number, and then by file name.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_ISSUE_PIPELINE_H
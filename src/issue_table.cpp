@@ -0,0 +1,126 @@
+#include "issue_table.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+void copy_row(lwg::issue_table & to, lwg::issue_table const & from, lwg::issue_row row) {
+   to.num.push_back(from.num[row]);
+   to.status_priority.push_back(from.status_priority[row]);
+   to.status.push_back(from.status[row]);
+   to.priority.push_back(from.priority[row]);
+   to.section.push_back(from.section[row]);
+   to.mod_date.push_back(from.mod_date[row]);
+   to.body.push_back(from.body[row]);
+}
+
+} // close unnamed namespace
+
+
+auto lwg::issue_table::rows() const -> std::vector<issue_row> {
+   std::vector<issue_row> result(size());
+   for (issue_row row{0}; row != result.size(); ++row) {
+      result[row] = row;
+   }
+   return result;
+}
+
+
+auto lwg::make_issue_table(std::vector<issue> const & issues, section_index const & section_db) -> issue_table {
+   issue_table table;
+   auto const n = issues.size();
+   table.num.reserve(n);
+   table.status_priority.reserve(n);
+   table.status.reserve(n);
+   table.priority.reserve(n);
+   table.section.reserve(n);
+   table.mod_date.reserve(n);
+   table.body.reserve(n);
+
+   std::map<std::string, unsigned char> status_codes;
+   std::vector<section_num const *> first_sections;
+   first_sections.reserve(n);
+
+   for (auto const & iss : issues) {
+      auto code = status_codes.find(iss.stat);
+      if (code == status_codes.end()) {
+         if (table.statuses.size() > 0xFF) {
+            throw std::runtime_error{"Too many distinct statuses to tabulate"};
+         }
+         code = status_codes.emplace(iss.stat, static_cast<unsigned char>(table.statuses.size())).first;
+         table.statuses.push_back(iss.stat);
+      }
+
+      assert(!iss.tags.empty());
+      first_sections.push_back(&section_db[iss.tags.front()]);
+
+      table.num.push_back(iss.num);
+      table.status_priority.push_back(get_status_priority(iss.stat));
+      table.status.push_back(code->second);
+      table.priority.push_back(iss.priority);
+      table.mod_date.push_back(iss.mod_date);
+      table.body.push_back(&iss);
+   }
+
+   // Rank the distinct sections, giving equal section numbers the same rank, so that rows can be
+   // ordered by section comparing a single integer.
+   std::vector<section_num const *> distinct{first_sections};
+   std::sort(distinct.begin(), distinct.end());
+   distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+   std::vector<section_key> by_value;
+   by_value.reserve(distinct.size());
+   for (auto sn : distinct) {
+      by_value.emplace_back(*sn);
+   }
+   std::sort(by_value.begin(), by_value.end());
+
+   std::vector<std::pair<section_num const *, unsigned>> ranks;
+   ranks.reserve(by_value.size());
+   for (auto const & key : by_value) {
+      if (table.section_keys.empty()  or  !(table.section_keys.back() == key)) {
+         table.sections.push_back(&key.section());
+         table.section_keys.push_back(key);
+      }
+      ranks.emplace_back(&key.section(), static_cast<unsigned>(table.sections.size() - 1));
+   }
+   std::sort(ranks.begin(), ranks.end());
+
+   for (auto sn : first_sections) {
+      auto const r = std::lower_bound(ranks.begin(), ranks.end(), std::make_pair(sn, 0u));
+      table.section.push_back(r->second);
+   }
+
+   return table;
+}
+
+
+auto lwg::select_by_status(issue_table const & table, std::function<bool(std::string const &)> const & pred) -> issue_table {
+   std::vector<bool> wanted;
+   for (auto const & stat : table.statuses) {
+      wanted.push_back(pred(stat));
+   }
+
+   issue_table result;
+   result.statuses = table.statuses;
+   result.sections = table.sections;
+   result.section_keys = table.section_keys;
+   for (issue_row row{0}; row != table.size(); ++row) {
+      if (wanted[table.status[row]]) {
+         copy_row(result, table, row);
+      }
+   }
+   return result;
+}
+
+
+void lwg::append_rows(issue_table & table, issue_table const & other) {
+   assert(table.statuses == other.statuses);
+   assert(table.sections == other.sections);
+   for (issue_row row{0}; row != other.size(); ++row) {
+      copy_row(table, other, row);
+   }
+}
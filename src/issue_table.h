@@ -0,0 +1,67 @@
+#ifndef INCLUDE_LWG_ISSUE_TABLE_H
+#define INCLUDE_LWG_ISSUE_TABLE_H
+
+// A columnar view of a set of issues, for sorting and filtering without dragging the text of each issue
+// through the cache.  The fields that every index document sorts or groups by are copied into parallel
+// arrays, one row per issue, and everything else is reached through a pointer to the issue itself.
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "date.h"
+#include "issues.h"
+#include "sections.h"
+
+namespace lwg
+{
+
+using issue_row = std::size_t;
+
+struct issue_table {
+   // hot columns, one entry per row
+   std::vector<int>               num;              // issue number
+   std::vector<std::ptrdiff_t>    status_priority;  // 'get_status_priority' of the status
+   std::vector<unsigned char>     status;           // status, as an index into 'statuses'
+   std::vector<int>               priority;         // priority, as 'issue::priority'
+   std::vector<unsigned>          section;          // section of the first tag, as an index into 'sections'
+   std::vector<gregorian::date>   mod_date;         // date last modified
+
+   // cold column
+   std::vector<issue const *>     body;             // the issue described by each row
+
+   // dictionaries, shared by every row
+   std::vector<std::string>           statuses;     // every distinct status, in no particular order
+   std::vector<section_num const *>   sections;     // every distinct section, in ascending order
+   std::vector<section_key>           section_keys; // packed key of each of 'sections'
+
+   auto size() const noexcept -> std::size_t { return num.size(); }
+   auto empty() const noexcept -> bool { return num.empty(); }
+
+   auto operator[](issue_row row) const noexcept -> issue const & { return *body[row]; }
+   auto status_of(issue_row row) const noexcept -> std::string const & { return statuses[status[row]]; }
+   auto section_of(issue_row row) const noexcept -> section_num const & { return *sections[section[row]]; }
+   auto section_key_of(issue_row row) const noexcept -> section_key const & { return section_keys[section[row]]; }
+
+   auto rows() const -> std::vector<issue_row>;
+      // Return the index of every row, in row order, as a permutation to be sorted.
+};
+
+
+auto make_issue_table(std::vector<issue> const & issues, section_index const & section_db) -> issue_table;
+   // Return a table with one row for each of 'issues', in the same order.  The table refers to
+   // 'issues' and to the elements of 'section_db', which must outlive it.
+   //
+   // Throws 'runtime_error' if there are too many distinct statuses to code in a byte.
+
+auto select_by_status(issue_table const & table, std::function<bool(std::string const &)> const & pred) -> issue_table;
+   // Return a table holding, in order, the rows of 'table' whose status satisfies 'pred'.  The predicate
+   // is called once for each distinct status, rather than once per row.
+
+void append_rows(issue_table & table, issue_table const & other);
+   // Append every row of 'other' to 'table'.  Both tables must have been selected from the same table.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_ISSUE_TABLE_H
@@ -1,9 +1,12 @@
 #include "issues.h"
 
+#include "markup_scan.h"
 #include "sections.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cstring>
 #include <istream>
 #include <ostream>
 #include <string>
@@ -11,7 +14,6 @@
 
 #include <sstream>
 
-#include <ctime>
 #include <sys/stat.h>  // plan to factor this dependency out
 
 namespace {
@@ -20,41 +22,55 @@ static constexpr char const * LWG_CLOSED {"lwg-closed.html" };
 static constexpr char const * LWG_DEFECTS{"lwg-defects.html"};
 
 // date utilites may factor out again
-auto parse_month(std::string const & m) -> gregorian::month {
-   // This could be turned into an efficient map lookup with a suitable indexed container
-   return (m == "Jan") ? gregorian::jan
-        : (m == "Feb") ? gregorian::feb
-        : (m == "Mar") ? gregorian::mar
-        : (m == "Apr") ? gregorian::apr
-        : (m == "May") ? gregorian::may
-        : (m == "Jun") ? gregorian::jun
-        : (m == "Jul") ? gregorian::jul
-        : (m == "Aug") ? gregorian::aug
-        : (m == "Sep") ? gregorian::sep
-        : (m == "Oct") ? gregorian::oct
-        : (m == "Nov") ? gregorian::nov
-        : (m == "Dec") ? gregorian::dec
-        : throw std::runtime_error{"unknown month " + m};
+auto parse_month(char const * first, char const * last) -> gregorian::month {
+   // Month names are matched against one packed string of their abbreviations.
+   static char const names[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+   if (last - first == 3) {
+      for (int m = 0; m != 12; ++m) {
+         if (0 == std::memcmp(first, names + 3 * m, 3)) {
+            return gregorian::month{m + 1};
+         }
+      }
+   }
+   throw std::runtime_error{"unknown month " + std::string(first, last)};
 }
 
-auto parse_date(std::istream & temp) -> gregorian::date {
-   int d;
-   temp >> d;
-   if (temp.fail()) {
-      throw std::runtime_error{"date format error"};
-   }
+auto parse_date(char const * first, char const * last) -> gregorian::date {
+   // Parse a date in the "DD Mon YYYY" format of issue files, such as "14 Nov 2013", without allocating.
+   // Fields may be separated by any amount of whitespace, and anything after the year is ignored.
+   auto skip_space = [&] {
+      while (first != last  and  std::isspace(static_cast<unsigned char>(*first))) {
+         ++first;
+      }
+   };
 
-   std::string month;
-   temp >> month;
+   auto parse_number = [&]() -> int {
+      if (first == last  or  !std::isdigit(static_cast<unsigned char>(*first))) {
+         throw std::runtime_error{"date format error"};
+      }
+      int n{0};
+      for (; first != last  and  std::isdigit(static_cast<unsigned char>(*first)); ++first) {
+         if (n > 9999) {
+            throw std::runtime_error{"date format error"};
+         }
+         n = 10 * n + (*first - '0');
+      }
+      return n;
+   };
 
-   auto m = parse_month(month);
-   int y{ 0 };
-   temp >> y;
-   return m/gregorian::day{d}/y;
-}
+   skip_space();
+   int const d = parse_number();
 
-auto make_date(std::tm const & mod) -> gregorian::date {
-   return gregorian::year((unsigned short)(mod.tm_year+1900)) / (mod.tm_mon+1) / mod.tm_mday;
+   skip_space();
+   auto const month_first = first;
+   while (first != last  and  !std::isspace(static_cast<unsigned char>(*first))) {
+      ++first;
+   }
+   auto const m = parse_month(month_first, first);
+
+   skip_space();
+   int const y = parse_number();
+   return m/gregorian::day{d}/y;
 }
 
 auto report_date_file_last_modified(std::string const & filename) -> gregorian::date {
@@ -63,7 +79,7 @@ auto report_date_file_last_modified(std::string const & filename) -> gregorian::
       throw std::runtime_error{"call to stat failed for " + filename};
    }
 
-   return make_date(*std::localtime(&buf.st_mtime));
+   return gregorian::date::from_time(buf.st_mtime);
 }
 
 } // close unnamed namespace
@@ -139,6 +155,18 @@ auto lwg::is_ready(std::string stat) -> bool {
 }
 
 auto lwg::parse_issue_from_file(std::string tx, std::string const & filename, lwg::section_map & section_db) -> issue {
+   return parse_issue_fields(std::move(tx), filename, all_issue_fields, report_date_file_last_modified(filename), section_db);
+}
+
+auto lwg::parse_issue_from_file(std::string tx, std::string const & filename, gregorian::date mod_date, lwg::section_map & section_db) -> issue {
+   return parse_issue_fields(std::move(tx), filename, all_issue_fields, mod_date, section_db);
+}
+
+auto lwg::parse_issue_fields(std::string tx, std::string const & filename, unsigned fields, lwg::section_map & section_db) -> issue {
+   return parse_issue_fields(std::move(tx), filename, fields, gregorian::date{}, section_db);
+}
+
+auto lwg::parse_issue_fields(std::string tx, std::string const & filename, unsigned fields, gregorian::date mod_date, lwg::section_map & section_db) -> issue {
    struct bad_issue_file : std::runtime_error {
       bad_issue_file(std::string const & filename, char const * error_message)
          : runtime_error{"Error parsing issue file " + filename + ": " + error_message}
@@ -146,17 +174,31 @@ auto lwg::parse_issue_from_file(std::string tx, std::string const & filename, lw
       }
    };
 
-   issue is;
+   // Whether an issue has a resolution depends on its status, so the text is never parsed without it
+   if (fields & issue_text) {
+      fields |= issue_status;
+   }
+
+   // The fields are found in the order they appear in the file, so the scan stops after the last one
+   // wanted.  Every field before it is still located, which checks the file as far as it is read, but
+   // only the fields wanted are copied.
+   auto wanted   = [fields](issue_field field) { return (fields & field) != 0; };
+   auto finished = [fields](issue_field field) { return fields < 2u * field; };
+
+   issue is{};
 
    // Get issue number
-   auto k = tx.find("<issue num=\"");
+   auto k = find_markup_tag(tx, "<issue num=\"", 0);
    if (k == std::string::npos) {
       throw bad_issue_file{filename, "Unable to find issue number"};
    }
    k += sizeof("<issue num=\"") - 1;
-   auto l = tx.find('\"', k);
+   auto l = find_markup(tx, k, quote);
    std::istringstream temp{tx.substr(k, l-k)};
    temp >> is.num;
+   if (finished(issue_number)) {
+      return is;
+   }
 
    // Get issue status
    k = tx.find("status=\"", l);
@@ -164,31 +206,41 @@ auto lwg::parse_issue_from_file(std::string tx, std::string const & filename, lw
       throw bad_issue_file{filename, "Unable to find issue status"};
    }
    k += sizeof("status=\"") - 1;
-   l = tx.find('\"', k);
-   is.stat = tx.substr(k, l-k);
+   l = find_markup(tx, k, quote);
+   if (wanted(issue_status)) {
+      is.stat = tx.substr(k, l-k);
+   }
+   if (finished(issue_status)) {
+      return is;
+   }
 
    // Get issue title
-   k = tx.find("<title>", l);
+   k = find_markup_tag(tx, "<title>", l);
    if (k == std::string::npos) {
       throw bad_issue_file{filename, "Unable to find issue title"};
    }
    k +=  sizeof("<title>") - 1;
-   l = tx.find("</title>", k);
-   is.title = tx.substr(k, l-k);
+   l = find_markup_tag(tx, "</title>", k);
+   if (wanted(issue_title)) {
+      is.title = tx.substr(k, l-k);
+   }
+   if (finished(issue_title)) {
+      return is;
+   }
 
    // Get issue sections
-   k = tx.find("<section>", l);
+   k = find_markup_tag(tx, "<section>", l);
    if (k == std::string::npos) {
       throw bad_issue_file{filename, "Unable to find issue section"};
    }
    k += sizeof("<section>") - 1;
-   l = tx.find("</section>", k);
-   while (k < l) {
-      k = tx.find('\"', k);
+   l = find_markup_tag(tx, "</section>", k);
+   while (wanted(issue_sections)  and  k < l) {
+      k = find_markup(tx, k, quote);
       if (k >= l) {
           break;
       }
-      auto k2 = tx.find('\"', k+1);
+      auto k2 = find_markup(tx, k+1, quote);
       if (k2 >= l) {
          throw bad_issue_file{filename, "Unable to find issue section"};
       }
@@ -203,52 +255,67 @@ auto lwg::parse_issue_from_file(std::string tx, std::string const & filename, lw
       ++k;
    }
 
-   if (is.tags.empty()) {
+   if (wanted(issue_sections)  and  is.tags.empty()) {
       throw bad_issue_file{filename, "Unable to find issue section"};
    }
+   if (finished(issue_sections)) {
+      return is;
+   }
 
    // Get submitter
-   k = tx.find("<submitter>", l);
+   k = find_markup_tag(tx, "<submitter>", l);
    if (k == std::string::npos) {
       throw bad_issue_file{filename, "Unable to find issue submitter"};
    }
    k += sizeof("<submitter>") - 1;
-   l = tx.find("</submitter>", k);
-   is.submitter = tx.substr(k, l-k);
+   l = find_markup_tag(tx, "</submitter>", k);
+   if (wanted(issue_submitter)) {
+      is.submitter = tx.substr(k, l-k);
+   }
+   if (finished(issue_submitter)) {
+      return is;
+   }
 
    // Get date
-   k = tx.find("<date>", l);
+   k = find_markup_tag(tx, "<date>", l);
    if (k == std::string::npos) {
       throw bad_issue_file{filename, "Unable to find issue date"};
    }
    k += sizeof("<date>") - 1;
-   l = tx.find("</date>", k);
-   temp.clear();
-   temp.str(tx.substr(k, l-k));
+   l = find_markup_tag(tx, "</date>", k);
 
-   try {
-      is.date = parse_date(temp);
-
-      // Get modification date
-      is.mod_date = report_date_file_last_modified(filename);
+   if (wanted(issue_date)) {
+      try {
+         is.date = parse_date(tx.data() + k, tx.data() + std::min(l, tx.size()));
+      }
+      catch(std::exception const & ex) {
+         throw bad_issue_file{filename, ex.what()};
+      }
    }
-   catch(std::exception const & ex) {
-      throw bad_issue_file{filename, ex.what()};
+   if (finished(issue_date)) {
+      return is;
    }
 
    // Get priority - this element is optional
-   k = tx.find("<priority>", l);
+   k = find_markup_tag(tx, "<priority>", l);
    if (k != std::string::npos) {
       k += sizeof("<priority>") - 1;
-      l = tx.find("</priority>", k);
+      l = find_markup_tag(tx, "</priority>", k);
       if (l == std::string::npos) {
          throw bad_issue_file{filename, "Corrupt 'priority' element: no closing tag"};
       }
-      is.priority = std::stoi(tx.substr(k, l-k));
+      if (wanted(issue_priority)) {
+         is.priority = std::stoi(tx.substr(k, l-k));
+      }
    }
+   if (finished(issue_priority)) {
+      return is;
+   }
+
+   is.mod_date = mod_date;
 
    // Trim text to <discussion>
-   k = tx.find("<discussion>", l);
+   k = find_markup_tag(tx, "<discussion>", l);
    if (k == std::string::npos) {
       throw bad_issue_file{filename, "Unable to find issue discussion"};
    }
@@ -256,17 +323,17 @@ auto lwg::parse_issue_from_file(std::string tx, std::string const & filename, lw
 
    // Find out if issue has a proposed resolution
    if (is_active(is.stat)  or  "Pending WP" == is.stat) {
-      auto k2 = tx.find("<resolution>", 0);
+      auto k2 = find_markup_tag(tx, "<resolution>", 0);
       if (k2 == std::string::npos) {
          is.has_resolution = false;
       }
       else {
          k2 += sizeof("<resolution>") - 1;
-         auto l2 = tx.find("</resolution>", k2);
-         is.resolution = tx.substr(k2, l2 - k2);
-         if (is.resolution.length() < 15) {
+         auto l2 = std::min(find_markup_tag(tx, "</resolution>", k2), tx.size());
+         is.resolution = text_span{k2, l2};
+         if (is.resolution.size() < 15) {
             // Filter small ammounts of whitespace between tags, with no actual resolution
-            is.resolution.clear();
+            is.resolution = text_span{};
          }
 //         is.has_resolution = l2 - k2 > 15;
          is.has_resolution = !is.resolution.empty();
@@ -2,6 +2,7 @@
 #define INCLUDE_LWG_ISSUES_H
 
 // standard headers
+#include <cstddef>
 #include <map>
 #include <set>
 #include <string>
@@ -15,19 +16,28 @@ namespace lwg
 
 using section_tag = std::string;
 
+struct text_span {
+   // The characters [first, last) of a string held elsewhere
+   std::size_t  first;
+   std::size_t  last;
+
+   auto size() const noexcept -> std::size_t { return last - first; }
+   auto empty() const noexcept -> bool { return first == last; }
+};
+
 struct issue {
    int                        num;            // ID - issue number
    std::string                stat;           // current status of the issue
    std::string                title;          // descriptive title for the issue
    std::vector<section_tag>   tags;           // section(s) of the standard affected by the issue
    std::string                submitter;      // original submitter of the issue
-   gregorian::date            date;           // date the issue was filed
-   gregorian::date            mod_date;       // this no longer appears useful
+   gregorian::date            date{};         // date the issue was filed
+   gregorian::date            mod_date{};     // this no longer appears useful
    std::set<std::string>      duplicates;     // sorted list of duplicate issues, stored as html anchor references.
    std::string                text;           // text representing the issue
    int                        priority = 99;  // severity, 1 = critical, 4 = minor concern, 0 = trivial to resolve, 99 = not yet prioritised
    std::string                owner;          // person identified as taking ownership of drafting/progressing the issue
-   std::string                resolution;     // extracted resolution text (if any), also present in 'text'
+   text_span                  resolution{};   // position of the resolution text (if any) within 'text', once parsed, and again once formatted
    bool                       has_resolution; // 'true' if 'text' contains a proposed resolution
 };
 
@@ -52,6 +62,36 @@ auto parse_issue_from_file(std::string file_contents, std::string const & filena
   //
   // The filename is passed only to improve diagnostics.
 
+auto parse_issue_from_file(std::string file_contents, std::string const & filename, gregorian::date mod_date, lwg::section_map & section_db) -> issue;
+  // As above, but taking the date the file was last modified from the caller, who will often have
+  // found it along with the file, rather than calling 'stat' on 'filename'.
+
+
+enum issue_field : unsigned {
+   // The fields of an issue, in the order they appear in an issue file
+   issue_number     = 1u << 0,  // 'num'
+   issue_status     = 1u << 1,  // 'stat'
+   issue_title      = 1u << 2,  // 'title'
+   issue_sections   = 1u << 3,  // 'tags', which are added to the section index if unknown
+   issue_submitter  = 1u << 4,  // 'submitter'
+   issue_date       = 1u << 5,  // 'date'
+   issue_priority   = 1u << 6,  // 'priority'
+   issue_text       = 1u << 7,  // 'text', 'resolution', 'has_resolution' and 'mod_date', and implies 'issue_status'
+   all_issue_fields = (1u << 8) - 1u,
+};
+
+auto parse_issue_fields(std::string file_contents, std::string const & filename, unsigned fields, gregorian::date mod_date, lwg::section_map & section_db) -> issue;
+  // As above, but extracting only 'fields', a combination of 'issue_field' values, and leaving every
+  // other member of the result with its default value.  The file is read no further than the last field
+  // wanted, so tools that query only the first few fields of each issue never scan its discussion.
+  // 'section_db' is modified only if 'issue_sections' is wanted, and 'mod_date' is used only if
+  // 'issue_text' is wanted.  'issue_text' always extracts 'stat' as well, because 'has_resolution' and
+  // 'resolution' depend on it.
+
+auto parse_issue_fields(std::string file_contents, std::string const & filename, unsigned fields, lwg::section_map & section_db) -> issue;
+  // As above, for callers that have no use for the date the file was last modified, which is never
+  // looked up.
+
 
 // status string utilities - should probably factor into yet another file.
 
@@ -53,7 +53,6 @@
 // . XML parser
 
 // standard headers
-#include <fstream>
 #include <functional>
 #include <iostream>
 #include <iterator>
@@ -64,12 +63,12 @@
 
 // platform headers - requires a Posix compatible platform
 // The hope is to replace all of this with the filesystem TS
-#include <dirent.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
 // solution specific headers
+#include "issue_directory.h"
 #include "issues.h"
 #include "sections.h"
 
@@ -92,44 +91,20 @@ using namespace boost::filesystem;
 #endif
 
 
-auto read_file_into_string(std::string const & filename) -> std::string {
-   // read a text file completely into memory, and return its contents as
-   // a 'string' for further manipulation.
-
-   std::ifstream infile{filename.c_str()};
-   if (!infile.is_open()) {
-      throw std::runtime_error{"Unable to open file " + filename};
-   }
-
-   std::istreambuf_iterator<char> first{infile}, last{};
-   return std::string {first, last};
-}
-
 // Issue-list specific functionality for the rest of this file
 // ===========================================================
 
-void filter_issues(std::string const & issues_path, lwg::section_map & section_db, std::function<bool(lwg::issue const &)> predicate) {
-   // Open the specified directory, 'issues_path', and iterate all the '.xml' files
-   // it contains, parsing each such file as an LWG issue document.  Write to 'out'
-   // the number of every issue that satisfies the 'predicate'.
-   //
-   // The current implementation relies directly on POSIX headers, but the preferred
-   // direction for the future is to switch over to the filesystem TS using directory
-   // iterators.
-
-   std::unique_ptr<DIR, int(&)(DIR*)> dir{opendir(issues_path.c_str()), closedir};
-   if (!dir) {
-      throw std::runtime_error{"Unable to open issues dir"};
-   }
-
-   while ( dirent* entry = readdir(dir.get()) ) {
-      std::string const issue_file{ entry->d_name };
-      if (0 == issue_file.find("issue") ) {
-         auto const filename = issues_path + issue_file;
-         auto const iss = parse_issue_from_file(read_file_into_string(filename), filename, section_db);
-         if (predicate(iss)) {
-            std::cout << iss.num << '\n';
-         }
+void filter_issues(std::string const & issues_path, unsigned fields, std::function<bool(lwg::issue const &)> predicate) {
+   // Scan the specified directory, 'issues_path', for the 'issue*.xml' files it
+   // contains, parsing 'fields' from each such file as an LWG issue document.
+   // Write to 'out' the number of every issue that satisfies the 'predicate'.
+
+   lwg::issue_directory const dir{issues_path};
+   lwg::section_map section_db;  // unused unless 'fields' includes the sections
+   for (auto const & file : dir.files()) {
+      auto const iss = parse_issue_fields(dir.read(file), issues_path + file.name, fields, section_db);
+      if (predicate(iss)) {
+         std::cout << iss.num << '\n';
       }
    }
 }
@@ -145,8 +120,6 @@ void check_is_directory(std::string const & directory) {
 
 int main(int argc, char const* argv[]) {
    try {
-      bool trace_on{false};  // Will pick this up from the command line later
-
       if (argc != 2) {
          std::cerr << "Must specify exactly one status\n";
          return 2;
@@ -164,22 +137,8 @@ int main(int argc, char const* argv[]) {
 
       check_is_directory(path);
 
-      lwg::section_map section_db = [&] {
-         // This lambda expression scopes the lifetime of an open 'fstream'
-         auto filename = path + "meta-data/section.data";
-         std::ifstream infile{filename};
-         if (!infile.is_open()) {
-            throw std::runtime_error{"Can't open section.data at " + path + "meta-data"};
-         }
-
-         if (trace_on) {
-            std::cout << "Reading section-tag index from: " << filename << std::endl;
-         }
-
-         return lwg::read_section_db(infile);
-      }();
-
-      filter_issues(path + "xml/", section_db, [status](lwg::issue const & iss) { return status == iss.stat; });
+      // Only the number and status of each issue are needed, which are found at the head of its file
+      filter_issues(path + "xml/", lwg::issue_number | lwg::issue_status, [status](lwg::issue const & iss) { return status == iss.stat; });
    }
    catch(std::exception const & ex) {
       std::cout << ex.what() << std::endl;
@@ -56,8 +56,11 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <ctime>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -77,11 +80,20 @@
 #include <sys/types.h>
 
 // solution specific headers
+#include "allocation.h"
+#include "compressed_files.h"
+#include "issue_directory.h"
+#include "issue_export.h"
 #include "date.h"
+#include "issue_pipeline.h"
+#include "issue_table.h"
 #include "issues.h"
 #include "mailing_info.h"
 #include "report_generator.h"
+#include "revision_diff.h"
 #include "sections.h"
+#include "stage_profile.h"
+#include "toc_snapshot.h"
 
 
 #if 0
@@ -102,588 +114,182 @@ using namespace boost::filesystem;
 #endif
 
 
-auto read_file_into_string(std::string const & filename) -> std::string {
-   // read a text file completely into memory, and return its contents as
-   // a 'string' for further manipulation.
-
-   std::ifstream infile{filename.c_str()};
-   if (!infile.is_open()) {
-      throw std::runtime_error{"Unable to open file " + filename};
-   }
+// ============================================================================================================
 
-   std::istreambuf_iterator<char> first{infile}, last{};
-   return std::string {first, last};
+void check_is_directory(std::string const & directory) {
+  struct stat sb;
+  if (stat(directory.c_str(), &sb) != 0 || !S_ISDIR(sb.st_mode))
+    throw std::runtime_error(directory + " is not an existing directory");
 }
 
-// Issue-list specific functionality for the rest of this file
-// ===========================================================
-
-auto read_issues(std::string const & issues_path, lwg::section_map & section_db) -> std::vector<lwg::issue> {
-   // Open the specified directory, 'issues_path', and iterate all the '.xml' files
-   // it contains, parsing each such file as an LWG issue document.  Return the set
-   // of issues as a vector.
-   //
-   // The current implementation relies directly on POSIX headers, but the preferred
-   // direction for the future is to switch over to the filesystem TS using directory
-   // iterators.
-
-   std::unique_ptr<DIR, int(&)(DIR*)> dir{opendir(issues_path.c_str()), closedir};
-   if (!dir) {
-      throw std::runtime_error{"Unable to open issues dir"};
+auto newest_input_time(std::string const & path) -> std::time_t {
+   // Return the time that the newest input of the issues lists under 'path' was last modified: an issue
+   // file, the mailing information, the section index, compiled or not, or either snapshot of the previous
+   // revision, the text one that the revision diff is made from or the older HTML one.
+   std::time_t newest{0};
+   lwg::issue_directory const dir{path + "xml/"};
+   for (auto const & file : dir.files()) {
+      newest = std::max(newest, file.mtime);
    }
-
-   std::vector<lwg::issue> issues{};
-   while ( dirent* entry = readdir(dir.get()) ) {
-      std::string const issue_file{ entry->d_name };
-      if (0 == issue_file.find("issue") ) {
-         auto const filename = issues_path + issue_file;
-         issues.emplace_back(parse_issue_from_file(read_file_into_string(filename), filename, section_db));
+   for (auto const & filename : { path + "xml/lwg-issues.xml",
+                                  path + "meta-data/section.data",
+                                  path + "meta-data/section.idx",
+                                  path + "meta-data/lwg-toc.old.txt",
+                                  path + "meta-data/lwg-toc.old.html" }) {
+      struct stat sb;
+      if (stat(filename.c_str(), &sb) == 0) {
+         newest = std::max(newest, sb.st_mtime);
       }
    }
+   return newest;
+}
 
-   return issues;
+auto build_time(std::string const & path, bool reproducible) -> std::time_t {
+   // Return the time to stamp on every document: 'SOURCE_DATE_EPOCH' if set, as the reproducible-builds
+   // convention asks; else, for a reproducible run, the time of the newest input; else the time now.
+   if (char const * epoch = std::getenv("SOURCE_DATE_EPOCH")) {
+      char * end;
+      errno = 0;
+      long long const seconds = std::strtoll(epoch, &end, 10);
+      if (end == epoch  or  *end != '\0'  or  errno != 0  or  seconds < 0) {
+         throw std::runtime_error{std::string{"SOURCE_DATE_EPOCH is not a count of seconds: "} + epoch};
+      }
+      return static_cast<std::time_t>(seconds);
+   }
+   return reproducible ? newest_input_time(path) : std::time(nullptr);
 }
 
+// Every document made from the issues, for '--only' to select among
+char const * const document_names[] = {
+   "lwg-active.html",  "lwg-defects.html",  "lwg-closed.html",
+   "lwg-tentative.html",  "lwg-unresolved.html",  "lwg-immediate.html",  "lwg-issues-for-editor.html",
+   "lwg-toc.html",  "lwg-toc.txt",  "lwg-status.html",  "lwg-status-date.html",  "lwg-index.html",  "lwg-index-open.html",
+   "unresolved-toc.html",  "unresolved-status.html",  "unresolved-status-date.html",  "unresolved-index.html",  "unresolved-prioritized.html",
+   "votable-toc.html",  "votable-status.html",  "votable-status-date.html",  "votable-index.html",
+};
 
-auto read_issues_from_toc(std::string const & s) -> std::vector<std::tuple<int, std::string> > {
-   // parse all issues from the specified stream, 'is'.
-   // Throws 'runtime_error' if *any* parse step fails
-   //
-   // We assume 'is' refers to a "toc" html document, for either the current or a previous issues list.
-   // The TOC file consists of a sequence of HTML <tr> elements - each element is one issue/row in the table
-   //    First we read the whole stream into a single 'string'
-   //    Then we search the string for the first <tr> marker
-   //       The first row is the title row and does not contain an issue.
-   //       If cannt find the first row, we flag an error and exit
-   //    Next we loop through the string, searching for <tr> markers to indicate the start of each issue
-   //       We parse the issue number and status from each row, and append a record to the result vector
-   //       If any parse fails, throw a runtime_error
-   //    If debugging, display the results to 'cout'
-
-   // Skip the title row
-   auto i = s.find("<tr>");
-   if (std::string::npos == i) {
-      throw std::runtime_error{"Unable to find the first (title) row"};
-   }
+auto selector_matches(std::string const & selector, std::string const & document) -> bool {
+   // A selector names a document by its file name, with or without the extension, or a family of documents
+   // by the prefix they share, such as "votable" for 'votable-toc.html' and the rest of the votable set.
+   return selector == document
+       or selector == document.substr(0, document.rfind('.'))
+       or 0 == document.compare(0, selector.size() + 1, selector + '-');
+}
 
-   // Read all issues in table
-   std::vector<std::tuple<int, std::string> > issues;
-   for(;;) {
-      i = s.find("<tr>", i+4);
-      if (i == std::string::npos) {
-         break;
-      }
-      i = s.find("</a>", i);
-      auto j = s.rfind('>', i);
-      if (j == std::string::npos) {
-         throw std::runtime_error{"unable to parse issue number: can't find beginning bracket"};
+auto parse_document_selection(std::string const & list) -> std::vector<std::string> {
+   // Split the comma-separated 'list' of selectors, each of which must select at least one document
+   std::vector<std::string> selectors;
+   std::istringstream in{list};
+   for (std::string selector; std::getline(in, selector, ',');) {
+      if (selector.empty()) {
+         continue;
       }
-      std::istringstream instr{s.substr(j+1, i-j-1)};
-      int num;
-      instr >> num;
-      if (instr.fail()) {
-         throw std::runtime_error{"unable to parse issue number"};
+      if (std::none_of(std::begin(document_names), std::end(document_names), [&](char const * document) { return selector_matches(selector, document); })) {
+         throw std::runtime_error{"No document is selected by " + selector};
       }
-      i = s.find("</a>", i+4);
-      if (i == std::string::npos) {
-         throw std::runtime_error{"partial issue found"};
-      }
-      j = s.rfind('>', i);
-      if (j == std::string::npos) {
-         throw std::runtime_error{"unable to parse issue status: can't find beginning bracket"};
-      }
-      issues.emplace_back(num, s.substr(j+1, i-j-1));
+      selectors.push_back(selector);
    }
-
-   return issues;
+   if (selectors.empty()) {
+      throw std::runtime_error{"--only needs at least one document"};
+   }
+   return selectors;
 }
 
+template <typename Writer>
+void export_issues(std::string const & filename, std::vector<lwg::issue> const & issues, lwg::section_index const & sections, bool include_text, Writer write) {
+   // The exports have their own line endings, so are written in binary mode
+   std::ofstream out{filename, std::ios::out | std::ios::binary};
+   if (!out) {
+      throw std::runtime_error{"Failed to open " + filename};
+   }
+   write(out, issues, sections, include_text);
+   std::cout << "Exported issues to " << filename << '\n';
+}
 
-// ============================================================================================================
-
-void format_issue_as_html(lwg::issue & is,
-                          std::vector<lwg::issue>::iterator first_issue,
-                          std::vector<lwg::issue>::iterator last_issue,
-                          lwg::section_map & section_db) {
-   // Reformt the issue text for the specified 'is' as valid HTML, replacing all the issue-list
-   // specific XML markup as appropriate:
-   //   tag             replacement
-   //   ---             ----------- 
-   //   iref            internal reference to another issue, replace with an anchor tag to that issue
-   //   sref            section-tag reference, replace with formatted tag and section-number
-   //   discussion      <p><b>Discussion:</b></p>CONTENTS
-   //   resolution      <p><b>Proposed resolution:</b></p>CONTENTS
-   //   rationale       <p><b>Rationale:</b></p>CONTENTS
-   //   duplicate       tags are erased, leaving just CONTENTS
-   //   note            <p><i>[NOTE CONTENTS]</i></p>
-   //   !--             comments are simply erased
-   //
-   // In addition, as duplicate issues are discovered, the duplicates are marked up
-   // in the supplied range [first_issue,last_issue).  Similarly, if an unexpected
-   // (unknown) section is discovered, it will be inserted into the supplied
-   // section index, 'section_db'.
-   //
-   // The behavior is undefined unless the issues in the supplied vector range are sorted by issue-number.
-   //
-   // Essentially, this function is a tiny xml-parser driven by a stack of open tags, that pops as tags
-   // are closed.
-
-   auto fix_tags = [&](std::string &s) {
-   int issue_num = is.num;     // current issue number for the issue being formatted
-   std::vector<std::string> tag_stack;   // stack of open XML tags as we parse
-   std::ostringstream er;      // stream to format error messages
-
-   // cannot rewrite as range-based for-loop as the string 's' is modified within the loop
-   for (std::string::size_type i{0}; i < s.size(); ++i) {
-      if (s[i] == '<') {
-         auto j = s.find('>', i);
-         if (j == std::string::npos) {
-            er.clear();
-            er.str("");
-            er << "missing '>' in issue " << issue_num;
-            throw std::runtime_error{er.str()};
+int main(int argc, char* argv[]) {
+   try {
+      // Usage: lists [--profile[=FILE]] [--arena] [--gzip] [--brotli] [--reproducible] [--json] [--csv] [--export-text] [--issue-pages] [--only=DOCS] [--check] [path]
+      // Profiling writes the cost of each stage as JSON to FILE, or to 'mailing/lists-profile.json'
+      // '--arena' reads and formats the issues in a monotonic arena, rather than on the heap
+      // '--gzip' and '--brotli' write a compressed sibling of each document, such as 'lwg-active.html.gz'
+      // '--reproducible' stamps the documents with the time of the newest input, rather than the time now,
+      // so that unchanged inputs give unchanged documents; 'SOURCE_DATE_EPOCH', if set, overrides both
+      // Documents whose contents are unchanged are not rewritten
+      // '--json' and '--csv' export the issues database as 'lwg-issues.jsonl' and 'lwg-issues.csv', and
+      // '--export-text' adds the formatted text of each issue to the exports
+      // '--issue-pages' also writes a page for each issue and each section, under 'mailing/issues/' and
+      // 'mailing/sections/', and links the index documents to them
+      // '--only' makes just the documents named in the comma-separated DOCS, such as 'lwg-unresolved.html',
+      // 'lwg-toc' (both 'lwg-toc.html' and 'lwg-toc.txt') or 'votable' (the 'votable-*' set), and formats only
+      // the issues whose text those documents print
+      // '--check' validates every issue file, reporting all the problems found, and writes nothing
+      std::string path;
+      bool profiling{false};
+      bool use_arena{false};
+      bool reproducible{false};
+      bool export_json{false};
+      bool export_csv{false};
+      bool export_text{false};
+      bool issue_pages{false};
+      bool check_only{false};
+      std::vector<std::string> only;   // selectors given to '--only', or empty to make every document
+      lwg::compression_formats compression;
+      std::string profile_filename;
+      for (int i{1}; i < argc; ++i) {
+         std::string const arg{argv[i]};
+         if (arg == "--profile") {
+            profiling = true;
          }
-
-         std::string tag;
-         {
-            std::istringstream iword{s.substr(i+1, j-i-1)};
-            iword >> tag;
+         else if (0 == arg.compare(0, 10, "--profile=")) {
+            profiling = true;
+            profile_filename = arg.substr(10);
          }
-
-         if (tag.empty()) {
-             er.clear();
-             er.str("");
-             er << "unexpected <> in issue " << issue_num;
-             throw std::runtime_error{er.str()};
+         else if (arg == "--arena") {
+            use_arena = true;
          }
-
-         if (tag[0] == '/') { // closing tag
-             tag.erase(tag.begin());
-             if (tag == "issue"  or  tag == "revision") {
-                s.erase(i, j-i + 1);
-                --i;
-                return;
-             }
-
-             if (tag_stack.empty()  or  tag != tag_stack.back()) {
-                er.clear();
-                er.str("");
-                er << "mismatched tags in issue " << issue_num;
-                if (tag_stack.empty()) {
-                   er << ".  Had no open tag.";
-                }
-                else {
-                   er << ".  Open tag was " << tag_stack.back() << ".";
-                }
-                er << "  Closing tag was " << tag;
-                throw std::runtime_error{er.str()};
-             }
-
-             tag_stack.pop_back();
-             if (tag == "discussion") {
-                 s.erase(i, j-i + 1);
-                 --i;
-             }
-             else if (tag == "resolution") {
-                 s.erase(i, j-i + 1);
-                 --i;
-             }
-             else if (tag == "rationale") {
-                 s.erase(i, j-i + 1);
-                 --i;
-             }
-             else if (tag == "duplicate") {
-                 s.erase(i, j-i + 1);
-                 --i;
-             }
-             else if (tag == "note") {
-                 s.replace(i, j-i + 1, "]</i></p>\n");
-                 i += 9;
-             }
-             else {
-                 i = j;
-             }
-
-             continue;
+         else if (arg == "--reproducible") {
+            reproducible = true;
          }
-
-         if (s[j-1] == '/') { // self-contained tag: sref, iref
-            if (tag == "sref") {
-               static const
-               auto report_missing_quote = [](std::ostringstream & er, unsigned num) {
-                  er.clear();
-                  er.str("");
-                  er << "missing '\"' in sref in issue " << num;
-                  throw std::runtime_error{er.str()};
-               };
-
-               std::string r;
-               auto k = s.find('\"', i+5);
-               if (k >= j) {
-                  report_missing_quote(er, issue_num);
-               }
-
-               auto l = s.find('\"', k+1);
-               if (l >= j) {
-                  report_missing_quote(er, issue_num);
-               }
-
-               ++k;
-               r = s.substr(k, l-k);
-               {
-                  std::ostringstream t;
-                  t << section_db[r] << ' ';
-                  r.insert(0, t.str());
-               }
-
-               j -= i - 1;
-               s.replace(i, j, r);
-               i += r.size() - 1;
-               continue;
-            }
-            else if (tag == "iref") {
-               static const
-               auto report_missing_quote = [](std::ostringstream & er, unsigned num) {
-                  er.clear();
-                  er.str("");
-                  er << "missing '\"' in iref in issue " << num;
-                  throw std::runtime_error{er.str()};
-               };
-
-               auto k = s.find('\"', i+5);
-               if (k >= j) {
-                  report_missing_quote(er, issue_num);
-               }
-               auto l = s.find('\"', k+1);
-               if (l >= j) {
-                  report_missing_quote(er, issue_num);
-               }
-
-               ++k;
-               std::string r{s.substr(k, l-k)};
-               std::istringstream temp{r};
-               int num;
-               temp >> num;
-               if (temp.fail()) {
-                  er.clear();
-                  er.str("");
-                  er << "bad number in iref in issue " << issue_num;
-                  throw std::runtime_error{er.str()};
-               }
-
-               auto n = std::lower_bound(first_issue, last_issue, num, lwg::order_by_issue_number{});
-               if (n == last_issue  or  n->num != num) {
-                  er.clear();
-                  er.str("");
-                  er << "could not find issue " << num << " for iref in issue " << issue_num;
-                  throw std::runtime_error{er.str()};
-               }
-
-               if (!tag_stack.empty()  and  tag_stack.back() == "duplicate") {
-                  n->duplicates.insert(make_html_anchor(is));
-                  is.duplicates.insert(make_html_anchor(*n));
-                  r.clear();
-               }
-               else {
-                  r = make_html_anchor(*n);
-               }
-
-               j -= i - 1;
-               s.replace(i, j, r);
-               i += r.size() - 1;
-               continue;
-            }
-            i = j;
-            continue;  // don't worry about this <tag/>
+         else if (arg == "--json") {
+            export_json = true;
          }
-
-         tag_stack.push_back(tag);
-         if (tag == "discussion") {
-             s.replace(i, j-i + 1, "<p><b>Discussion:</b></p>");
-             i += 24;
+         else if (arg == "--csv") {
+            export_csv = true;
          }
-         else if (tag == "resolution") {
-             s.replace(i, j-i + 1, "<p><b>Proposed resolution:</b></p>");
-             i += 33;
+         else if (arg == "--export-text") {
+            export_text = true;
          }
-         else if (tag == "rationale") {
-             s.replace(i, j-i + 1, "<p><b>Rationale:</b></p>");
-             i += 23;
+         else if (arg == "--issue-pages") {
+            issue_pages = true;
          }
-         else if (tag == "duplicate") {
-             s.erase(i, j-i + 1);
-             --i;
+         else if (0 == arg.compare(0, 7, "--only=")) {
+            only = parse_document_selection(arg.substr(7));
          }
-         else if (tag == "note") {
-             s.replace(i, j-i + 1, "<p><i>[");
-             i += 6;
+         else if (arg == "--check") {
+            check_only = true;
          }
-         else if (tag == "!--") {
-             tag_stack.pop_back();
-             j = s.find("-->", i);
-             j += 3;
-             s.erase(i, j-i);
-             --i;
+         else if (arg == "--gzip") {
+            compression.gzip = true;
+         }
+         else if (arg == "--brotli") {
+            // Refuse before any document is written, rather than after every document is published
+            if (!lwg::brotli_is_available()) {
+               throw std::runtime_error{"--brotli requires a build of lists with LWG_WITH_BROTLI"};
+            }
+            compression.brotli = true;
+         }
+         else if (path.empty()) {
+            path = arg;
          }
          else {
-             i = j;
+            throw std::runtime_error{"Unexpected argument " + arg};
          }
       }
-   }
-   };
-
-   fix_tags(is.text);
-   fix_tags(is.resolution);
-
-}
-
-
-void prepare_issues(std::vector<lwg::issue> & issues, lwg::section_map & section_db) {
-   // Initially sort the issues by issue number, so each issue can be correctly 'format'ted
-   sort(issues.begin(), issues.end(), lwg::order_by_issue_number{});
-
-   // Then we format the issues, which should be the last time we need to touch the issues themselves
-   // We may turn this into a two-stage process, analysing duplicates and then applying the links
-   // This will allow us to better express constness when the issues are used purely for reference.
-   // Currently, the 'format' function takes a reference-to-non-const-vector-of-issues purely to
-   // mark up information related to duplicates, so processing duplicates in a separate pass may
-   // clarify the code.
-   for (auto & i : issues) { format_issue_as_html(i, issues.begin(), issues.end(), section_db); }
-
-   // Issues will be routinely re-sorted in later code, but contents should be fixed after formatting.
-   // This suggests we may want to be storing some kind of issue handle in the functions that keep
-   // re-sorting issues, and so minimize the churn on the larger objects.
-}
-
-
-// ============================================================================================================
-
-auto prepare_issues_for_diff_report(std::vector<lwg::issue> const & issues) -> std::vector<std::tuple<int, std::string> > {
-   std::vector<std::tuple<int, std::string> > result;
-   std::transform( issues.begin(), issues.end(), back_inserter(result),
-#if 1
-                   [](lwg::issue const & iss) { return std::make_tuple(iss.num, iss.stat); }
-#else
-                   // This form does not work because tuple constructors are explicit
-                   [](lwg::issue const & iss) -> std::tuple<int, std::string> { return {iss.num, iss.stat}; }
-#endif
-                 );
-   return result;
-}
-
-struct list_issues {
-   std::vector<int> const & issues;
-};
-
-
-auto operator<<( std::ostream & out, list_issues const & x) -> std::ostream & {
-   auto list_separator = "";
-   for (auto number : x.issues ) {
-      out << list_separator << "<iref ref=\"" << number << "\"/>";
-      list_separator = ", ";
-   }
-   return out;
-}
-
-
-struct find_num {
-   // Predidate functor useful to find issue 'y' in a mapping of issue-number -> some string.
-    bool operator()(std::tuple<int, std::string> const & x, int y) const noexcept {
-      return std::get<0>(x) < y;
-   }
-};
-
-
-struct discover_new_issues {
-   std::vector<std::tuple<int, std::string> > const & old_issues;
-   std::vector<std::tuple<int, std::string> > const & new_issues;
-};
-
-
-auto operator<<( std::ostream & out, discover_new_issues const & x) -> std::ostream & {
-   std::vector<std::tuple<int, std::string> > const & old_issues = x.old_issues;
-   std::vector<std::tuple<int, std::string> > const & new_issues = x.new_issues;
-
-   struct status_order {
-      // predicate for 'map'
-
-      using status_string = std::string;
-      auto operator()(status_string const & x, status_string const & y) const noexcept -> bool {
-         return { lwg::get_status_priority(x) < lwg::get_status_priority(y) };
-      }
-   };
-
-   std::map<std::string, std::vector<int>, status_order> added_issues;
-   for (auto const & i : new_issues ) {
-      auto j = std::lower_bound(old_issues.cbegin(), old_issues.cend(), std::get<0>(i), find_num{});
-      if(j == old_issues.end()) {
-         added_issues[std::get<1>(i)].push_back(std::get<0>(i));
-      }
-   }
-
-   for (auto const & i : added_issues ) {
-      auto const item_count = std::get<1>(i).size();
-      if(1 == item_count) {
-         out << "<li>Added the following " << std::get<0>(i) << " issue: <iref ref=\"" << std::get<1>(i).front() << "\"/>.</li>\n";
-      }
-      else {
-         out << "<li>Added the following " << item_count << " " << std::get<0>(i) << " issues: " << list_issues{std::get<1>(i)} << ".</li>\n";
-      }
-   }
-   
-   if (added_issues.empty()) {
-      out << "<li>No issues added.</li>\n";
-   }
-
-   return out;
-}
-
-
-struct discover_changed_issues {
-   std::vector<std::tuple<int, std::string> > const & old_issues;
-   std::vector<std::tuple<int, std::string> > const & new_issues;
-};
-
-
-auto operator << (std::ostream & out, discover_changed_issues x) -> std::ostream & {
-   std::vector<std::tuple<int, std::string> > const & old_issues = x.old_issues;
-   std::vector<std::tuple<int, std::string> > const & new_issues = x.new_issues;
-
-   struct status_transition_order {
-      using status_string = std::string;
-      using from_status_to_status = std::tuple<status_string, status_string>;
 
-      auto operator()(from_status_to_status const & x, from_status_to_status const & y) const noexcept -> bool {
-         auto const xp2 = lwg::get_status_priority(std::get<1>(x));
-         auto const yp2 = lwg::get_status_priority(std::get<1>(y));
-         return xp2 < yp2  or  (!(yp2 < xp2)  and  lwg::get_status_priority(std::get<0>(x)) < lwg::get_status_priority(std::get<0>(y)));
+      if (!check_only) {
+         std::cout << "Preparing new LWG issues lists..." << std::endl;
       }
-   };
-
-   std::map<std::tuple<std::string, std::string>, std::vector<int>, status_transition_order> changed_issues;
-   for (auto const & i : new_issues ) {
-      auto j = std::lower_bound(old_issues.begin(), old_issues.end(), std::get<0>(i), find_num{});
-      if (j != old_issues.end()  and  std::get<0>(i) == std::get<0>(*j)  and  std::get<1>(*j) != std::get<1>(i)) {
-         changed_issues[std::tuple<std::string, std::string>{std::get<1>(*j), std::get<1>(i)}].push_back(std::get<0>(i));
-      }
-   }
-
-   for (auto const & i : changed_issues ) {
-      auto const item_count = std::get<1>(i).size();
-      if(1 == item_count) {
-         out << "<li>Changed the following issue to " << std::get<1>(std::get<0>(i))
-             << " (from " << std::get<0>(std::get<0>(i)) << "): <iref ref=\"" << std::get<1>(i).front() << "\"/>.</li>\n";
-      }
-      else {
-         out << "<li>Changed the following " << item_count << " issues to " << std::get<1>(std::get<0>(i))
-             << " (from " << std::get<0>(std::get<0>(i)) << "): " << list_issues{std::get<1>(i)} << ".</li>\n";
-      }
-   }
-
-   if (changed_issues.empty()) {
-      out << "<li>No issues changed.</li>\n";
-   }
-
-   return out;
-}
-
-
-void count_issues(std::vector<std::tuple<int, std::string> > const & issues, unsigned & n_open, unsigned & n_closed) {
-   n_open = 0;
-   n_closed = 0;
-
-   for(auto const & elem : issues) {
-      if (lwg::is_active(std::get<1>(elem))) {
-         ++n_open;
-      }
-      else {
-         ++n_closed;
-      }
-   }
-}
-
-
-struct write_summary {
-   std::vector<std::tuple<int, std::string> > const & old_issues;
-   std::vector<std::tuple<int, std::string> > const & new_issues;
-};
-
-
-auto operator << (std::ostream & out, write_summary const & x) -> std::ostream & {
-   std::vector<std::tuple<int, std::string> > const & old_issues = x.old_issues;
-   std::vector<std::tuple<int, std::string> > const & new_issues = x.new_issues;
-
-   unsigned n_open_new = 0;
-   unsigned n_open_old = 0;
-   unsigned n_closed_new = 0;
-   unsigned n_closed_old = 0;
-   count_issues(old_issues, n_open_old, n_closed_old);
-   count_issues(new_issues, n_open_new, n_closed_new);
-
-   out << "<li>" << n_open_new << " open issues, ";
-   if (n_open_new >= n_open_old) {
-      out << "up by " << n_open_new - n_open_old;
-   }
-   else {
-      out << "down by " << n_open_old - n_open_new;
-   }
-   out << ".</li>\n";
-
-   out << "<li>" << n_closed_new << " closed issues, ";
-   if (n_closed_new >= n_closed_old) {
-      out << "up by " << n_closed_new - n_closed_old;
-   }
-   else {
-      out << "down by " << n_closed_old - n_closed_new;
-   }
-   out << ".</li>\n";
-
-   unsigned n_total_new = n_open_new + n_closed_new;
-   unsigned n_total_old = n_open_old + n_closed_old;
-   out << "<li>" << n_total_new << " issues total, ";
-   if (n_total_new >= n_total_old) {
-      out << "up by " << n_total_new - n_total_old;
-   }
-   else {
-      out << "down by " << n_total_old - n_total_new;
-   }
-   out << ".</li>\n";
-
-   return out;
-}
-
-
-void print_current_revisions( std::ostream & out
-                            , std::vector<std::tuple<int, std::string> > const & old_issues
-                            , std::vector<std::tuple<int, std::string> > const & new_issues
-                            ) {
-   out << "<ul>\n"
-          "<li><b>Summary:</b><ul>\n"
-       << write_summary{old_issues, new_issues}
-       << "</ul></li>\n"
-          "<li><b>Details:</b><ul>\n"
-       << discover_new_issues{old_issues, new_issues}
-       << discover_changed_issues{old_issues, new_issues}
-       << "</ul></li>\n"
-          "</ul>\n";
-}
-
-// ============================================================================================================
-
-void check_is_directory(std::string const & directory) {
-  struct stat sb;
-  if (stat(directory.c_str(), &sb) != 0 || !S_ISDIR(sb.st_mode))
-    throw std::runtime_error(directory + " is not an existing directory");
-}
-
-int main(int argc, char* argv[]) {
-   try {
-      std::string path;
-      std::cout << "Preparing new LWG issues lists..." << std::endl;
-      if (argc == 2) {
-         path = argv[1];
-      }
-      else {
+      if (path.empty()) {
          char cwd[1024];
          if (getcwd(cwd, sizeof(cwd)) == 0) {
             std::cout << "unable to getcwd\n";
@@ -694,21 +300,27 @@ int main(int argc, char* argv[]) {
 
       if (path.back() != '/') { path += '/'; }
       check_is_directory(path);
+
+      if (check_only) {
+         auto const section_db = lwg::load_section_db(path + "meta-data/");
+         auto const diagnostics = lwg::check_issues(path + "xml/", section_db);
+         for (auto const & d : diagnostics) {
+            std::cout << "xml/" << d.filename << ": issue " << d.num << ": " << d.message << '\n';
+         }
+         std::cout << diagnostics.size() << (diagnostics.size() == 1 ? " problem" : " problems") << " found" << std::endl;
+         return diagnostics.empty() ? 0 : 1;
+      }
 	  
       const std::string target_path{path + "mailing/"};
       check_is_directory(target_path);
 	  
+      lwg::stage_profile profile{profiling};
 
-      lwg::section_map section_db =[&path]() {
-         auto filename = path + "meta-data/section.data";
-         std::ifstream infile{filename};
-         if (!infile.is_open()) {
-            throw std::runtime_error{"Can't open section.data at " + path + "meta-data"};
-         }
-         std::cout << "Reading section-tag index from: " << filename << std::endl;
+      lwg::section_map section_db = profile.measure("section index", [&path]() {
+         std::cout << "Reading section-tag index from: " << path << "meta-data/section.data" << std::endl;
 
-         return lwg::read_section_db(infile);
-      }();
+         return lwg::load_section_db(path + "meta-data/");
+      });
 #if defined (DEBUG_LOGGING)
       // dump the contents of the section index
       for (auto const & elem : section_db ) {
@@ -719,11 +331,13 @@ int main(int argc, char* argv[]) {
       }
 #endif
  
-      auto const old_issues = read_issues_from_toc(read_file_into_string(path + "meta-data/lwg-toc.old.html"));
+      auto const old_issues = profile.measure("toc snapshot", [&path]() {
+         return lwg::load_toc_snapshot(path + "meta-data/lwg-toc.old.html");
+      });
 
       auto const issues_path = path + "xml/";
 
-      lwg::mailing_info lwg_issues_xml = [&issues_path](){
+      lwg::mailing_info lwg_issues_xml = profile.measure("mailing info", [&issues_path](){
          std::string filename{issues_path + "lwg-issues.xml"};
          std::ifstream infile{filename};
          if (!infile.is_open()) {
@@ -731,17 +345,49 @@ int main(int argc, char* argv[]) {
          }
 
          return lwg::mailing_info{infile};
-      }();
+      });
 
       //lwg::mailing_info lwg_issues_xml{issues_path};
 
 
-      std::cout << "Reading issues from: " << issues_path << std::endl;
-      auto issues = read_issues(issues_path, section_db);
-      prepare_issues(issues, section_db);
+      auto const selected = [&only](std::string const & document) {
+         return only.empty()  or  std::any_of(only.begin(), only.end(), [&](std::string const & selector) { return selector_matches(selector, document); });
+      };
+
+      // Format only the issues whose text a selected document prints.  Every other issue is still read,
+      // as the documents refer to it by number and status, and list it in their indexes.
+      std::vector<std::string> selected_documents;
+      std::copy_if(std::begin(document_names), std::end(document_names), std::back_inserter(selected_documents), selected);
+      bool const format_all{only.empty()  or  issue_pages  or  (export_text  and  (export_json  or  export_csv))};
+      auto const needs_text = [&](lwg::issue const & iss) {
+         return format_all
+             or std::any_of(selected_documents.begin(), selected_documents.end(), [&](std::string const & document) { return lwg::prints_issue_text(document, iss); });
+      };
+
+      // With '--arena', the issues are read and formatted in the arena, where their strings are made and
+      // kept.  The temporaries of reading and formatting are then never reclaimed, which costs more memory
+      // than the heap saves, so the arena is only an experiment.  The documents are always made on the heap.
+      std::vector<lwg::issue> issues;
+      lwg::section_index sections;
+      lwg::reference_graph references;
+      {
+         lwg::arena_scope arena{use_arena};
+
+         std::cout << "Reading issues from: " << issues_path << std::endl;
+         issues = profile.measure("read_issues", [&]() { return lwg::read_issues(issues_path, section_db); });
+
+         // Every section is known once the issues are read, so freeze the index for the lookups that follow
+         sections = profile.measure("freeze section index", [&]() { return lwg::section_index{section_db}; });
+         references = profile.measure("prepare_issues", [&]() { return lwg::prepare_issues(issues, sections, needs_text); });
+      }
 
 
-      lwg::report_generator generator{lwg_issues_xml, section_db};
+      lwg::report_generator generator{lwg_issues_xml, sections, references, build_time(path, reproducible)};
+      auto make_document = [&](std::string const & document, std::string const & stage, std::function<void()> make) {
+         if (selected(document)) {
+            profile.measure(stage, make);
+         }
+      };
 
 
       // issues must be sorted by number before making the mailing list documents
@@ -749,68 +395,105 @@ int main(int argc, char* argv[]) {
 
       // Collect a report on all issues that have changed status
       // This will be added to the revision history of the 3 standard documents
-      auto const new_issues = prepare_issues_for_diff_report(issues);
+      auto const new_issues = profile.measure("toc snapshot (new)", [&]() { return lwg::make_toc_snapshot(issues); });
 
-      std::ostringstream os_diff_report;
-      print_current_revisions(os_diff_report, old_issues, new_issues );
-      auto const diff_report = os_diff_report.str();
+      auto const diff_report = profile.measure("diff report", [&]() {
+         std::ostringstream os_diff_report;
+         lwg::print_current_revisions(os_diff_report, old_issues, new_issues);
+         return os_diff_report.str();
+      });
 
-      std::vector<lwg::issue> unresolved_issues;
-      std::vector<lwg::issue> votable_issues;
+      // The index documents sort and filter a columnar table of the issues, rather than the issues themselves
+      auto const all_issues = profile.measure("issue table", [&]() { return lwg::make_issue_table(issues, sections); });
 
-      std::copy_if(issues.begin(), issues.end(), std::back_inserter(unresolved_issues), [](lwg::issue const & iss){ return lwg::is_not_resolved(iss.stat); } );
-      std::copy_if(issues.begin(), issues.end(), std::back_inserter(votable_issues),    [](lwg::issue const & iss){ return lwg::is_votable(iss.stat); } );
+      auto unresolved_issues = lwg::select_by_status(all_issues, [](std::string const & stat){ return lwg::is_not_resolved(stat); } );
+      auto votable_issues    = lwg::select_by_status(all_issues, [](std::string const & stat){ return lwg::is_votable(stat); } );
 
       // If votable list is empty, we are between meetings and should list Ready issues instead
       // Otherwise, issues moved to Ready during a meeting will remain 'unresolved' by that meeting
-      auto ready_inserter = votable_issues.empty()
-                          ? std::back_inserter(votable_issues)
-                          : std::back_inserter(unresolved_issues);
-      std::copy_if(issues.begin(), issues.end(), ready_inserter, [](lwg::issue const & iss){ return lwg::is_ready(iss.stat); } );
+      lwg::append_rows(votable_issues.empty() ? votable_issues : unresolved_issues,
+                       lwg::select_by_status(all_issues, [](std::string const & stat){ return lwg::is_ready(stat); } ));
 
       // First generate the primary 3 standard issues lists
-      generator.make_active(issues, target_path, diff_report);
-      generator.make_defect(issues, target_path, diff_report);
-      generator.make_closed(issues, target_path, diff_report);
+      make_document("lwg-active.html", "make_active", [&]() { generator.make_active(issues, target_path, diff_report); });
+      make_document("lwg-defects.html", "make_defect", [&]() { generator.make_defect(issues, target_path, diff_report); });
+      make_document("lwg-closed.html", "make_closed", [&]() { generator.make_closed(issues, target_path, diff_report); });
 
       // unofficial documents
-      generator.make_tentative (issues, target_path);
-      generator.make_unresolved(issues, target_path);
-      generator.make_immediate (issues, target_path);
-      generator.make_editors_issues(issues, target_path);
+      make_document("lwg-tentative.html", "make_tentative", [&]() { generator.make_tentative(issues, target_path); });
+      make_document("lwg-unresolved.html", "make_unresolved", [&]() { generator.make_unresolved(issues, target_path); });
+      make_document("lwg-immediate.html", "make_immediate", [&]() { generator.make_immediate(issues, target_path); });
+      make_document("lwg-issues-for-editor.html", "make_editors_issues", [&]() { generator.make_editors_issues(issues, target_path); });
+
+      // Pages for single issues and sections, made before the index documents so that those can link to them
+      if (issue_pages) {
+         profile.measure("make_issue_pages", [&]() { generator.make_issue_pages(issues, target_path); });
+      }
 
 
 
       // Now we have a parsed and formatted set of issues, we can write the standard set of HTML documents
-      // Note that each of these functions is going to re-sort the 'issues' vector for its own purposes
-      generator.make_sort_by_num            (issues, {target_path + "lwg-toc.html"});
-      generator.make_sort_by_status         (issues, {target_path + "lwg-status.html"});
-      generator.make_sort_by_status_mod_date(issues, {target_path + "lwg-status-date.html"});  // this report is useless, as git checkouts touch filestamps
-      generator.make_sort_by_section        (issues, {target_path + "lwg-index.html"});
+      // Note that each of these functions sorts its own permutation of the table, leaving 'issues' sorted by number
+      make_document("lwg-toc.html", "make_sort_by_num lwg-toc.html", [&]() { generator.make_sort_by_num(all_issues, {target_path + "lwg-toc.html"}); });
+      // The machine-readable snapshot is written alongside lwg-toc.html, so the next revision can diff against it
+      make_document("lwg-toc.txt", "make_toc_text lwg-toc.txt", [&]() { generator.make_toc_text(new_issues, {target_path + "lwg-toc.txt"}); });
+      make_document("lwg-status.html", "make_sort_by_status lwg-status.html", [&]() { generator.make_sort_by_status(all_issues, {target_path + "lwg-status.html"}); });
+      // this report is useless, as git checkouts touch filestamps
+      make_document("lwg-status-date.html", "make_sort_by_status_mod_date lwg-status-date.html", [&]() { generator.make_sort_by_status_mod_date(all_issues, {target_path + "lwg-status-date.html"}); });
+      make_document("lwg-index.html", "make_sort_by_section lwg-index.html", [&]() { generator.make_sort_by_section(all_issues, {target_path + "lwg-index.html"}); });
 
       // Note that this additional document is very similar to unresolved-index.html below
-      generator.make_sort_by_section        (issues, {target_path + "lwg-index-open.html"}, true);
+      make_document("lwg-index-open.html", "make_sort_by_section lwg-index-open.html", [&]() { generator.make_sort_by_section(all_issues, {target_path + "lwg-index-open.html"}, true); });
 
       // Make a similar set of index documents for the issues that are 'live' during a meeting
       // Note that these documents want to reference each other, rather than lwg- equivalents,
       // although it may not be worth attempting fix-ups as the per-issue level
       // During meetings, it would be good to list newly-Ready issues here
-      generator.make_sort_by_num            (unresolved_issues, {target_path + "unresolved-toc.html"});
-      generator.make_sort_by_status         (unresolved_issues, {target_path + "unresolved-status.html"});
-      generator.make_sort_by_status_mod_date(unresolved_issues, {target_path + "unresolved-status-date.html"});
-      generator.make_sort_by_section        (unresolved_issues, {target_path + "unresolved-index.html"});
-      generator.make_sort_by_priority       (unresolved_issues, {target_path + "unresolved-prioritized.html"});
+      make_document("unresolved-toc.html", "make_sort_by_num unresolved-toc.html", [&]() { generator.make_sort_by_num(unresolved_issues, {target_path + "unresolved-toc.html"}); });
+      make_document("unresolved-status.html", "make_sort_by_status unresolved-status.html", [&]() { generator.make_sort_by_status(unresolved_issues, {target_path + "unresolved-status.html"}); });
+      make_document("unresolved-status-date.html", "make_sort_by_status_mod_date unresolved-status-date.html", [&]() { generator.make_sort_by_status_mod_date(unresolved_issues, {target_path + "unresolved-status-date.html"}); });
+      make_document("unresolved-index.html", "make_sort_by_section unresolved-index.html", [&]() { generator.make_sort_by_section(unresolved_issues, {target_path + "unresolved-index.html"}); });
+      make_document("unresolved-prioritized.html", "make_sort_by_priority unresolved-prioritized.html", [&]() { generator.make_sort_by_priority(unresolved_issues, {target_path + "unresolved-prioritized.html"}); });
 
       // Make another set of index documents for the issues that are up for a vote during a meeting
       // Note that these documents want to reference each other, rather than lwg- equivalents,
       // although it may not be worth attempting fix-ups as the per-issue level
       // Between meetings, it would be good to list Ready issues here
-      generator.make_sort_by_num            (votable_issues, {target_path + "votable-toc.html"});
-      generator.make_sort_by_status         (votable_issues, {target_path + "votable-status.html"});
-      generator.make_sort_by_status_mod_date(votable_issues, {target_path + "votable-status-date.html"});
-      generator.make_sort_by_section        (votable_issues, {target_path + "votable-index.html"});
+      make_document("votable-toc.html", "make_sort_by_num votable-toc.html", [&]() { generator.make_sort_by_num(votable_issues, {target_path + "votable-toc.html"}); });
+      make_document("votable-status.html", "make_sort_by_status votable-status.html", [&]() { generator.make_sort_by_status(votable_issues, {target_path + "votable-status.html"}); });
+      make_document("votable-status-date.html", "make_sort_by_status_mod_date votable-status-date.html", [&]() { generator.make_sort_by_status_mod_date(votable_issues, {target_path + "votable-status-date.html"}); });
+      make_document("votable-index.html", "make_sort_by_section votable-index.html", [&]() { generator.make_sort_by_section(votable_issues, {target_path + "votable-index.html"}); });
+
+      std::cout << "Made " << (only.empty() ? "all" : std::to_string(generator.documents().size())) << " documents, rewriting " << generator.rewritten().size() << " of " << generator.documents().size() << "\n";
+
+      // Machine-readable exports, for tools that would otherwise scrape lwg-toc.html
+      if (export_json) {
+         profile.measure("export lwg-issues.jsonl", [&]() {
+            export_issues(target_path + "lwg-issues.jsonl", issues, sections, export_text, lwg::write_issues_json_lines);
+         });
+      }
+      if (export_csv) {
+         profile.measure("export lwg-issues.csv", [&]() {
+            export_issues(target_path + "lwg-issues.csv", issues, sections, export_text, lwg::write_issues_csv);
+         });
+      }
 
-      std::cout << "Made all documents\n";
+      if (compression.any()) {
+         profile.measure("compress documents", [&]() { generator.compress_documents(compression); });
+         std::cout << "Compressed all documents\n";
+      }
+
+      if (profile.enabled()) {
+         if (profile_filename.empty()) {
+            profile_filename = target_path + "lists-profile.json";
+         }
+         std::ofstream out{profile_filename};
+         if (!out) {
+            throw std::runtime_error{"Failed to open " + profile_filename};
+         }
+         profile.write_json(out);
+         std::cout << "Wrote profile to " << profile_filename << '\n';
+      }
    }
    catch(std::exception const & ex) {
       std::cout << ex.what() << std::endl;
@@ -0,0 +1,577 @@
+// This program measures how each stage of the 'lists' program scales with the size of the issues list.
+// It generates synthetic issue corpora of the requested sizes, valid input for 'parse_issue_from_file',
+// and times every stage of building the issues lists from them.
+//
+// Usage:
+//    lists_bench [--work DIR] [--keep] [COUNT]...      benchmark synthetic corpora of COUNT issues
+//    lists_bench [--work DIR] --corpus PATH            benchmark an existing issues tree, such as a checkout
+//
+// By default corpora of 10000, 100000 and 1000000 issues are generated.  Corpora are written beneath
+// DIR, defaulting to $TMPDIR or /tmp, and removed afterwards unless --keep is given.  Synthetic issues
+// use the sections of meta-data/section.data in the current directory.  Each synthetic corpus is followed
+// by a single issue of several megabytes, to time the scanning of its markup apart from everything else.
+// An existing issues tree is only read: its documents are written to a scratch directory beneath DIR,
+// which is removed afterwards, so the 'mailing' directory of a checkout is never touched.
+//
+// For every stage, the report gives the elapsed time, the items (issues, or sections) handled per second
+// and, for stages that read or write files, the megabytes handled per second.
+
+// standard headers
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// platform headers - requires a Posix compatible platform
+// The hope is to replace all of this with the filesystem TS
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#if defined(_WIN32)
+#include <direct.h>
+#include <io.h>
+#endif
+
+// solution specific headers
+#include "compressed_files.h"
+#include "issue_directory.h"
+#include "issue_export.h"
+#include "issue_pipeline.h"
+#include "issue_table.h"
+#include "markup_scan.h"
+#include "issues.h"
+#include "mailing_info.h"
+#include "report_generator.h"
+#include "revision_diff.h"
+#include "sections.h"
+#include "toc_snapshot.h"
+
+
+namespace {
+
+// Synthetic corpus generation
+// ===========================
+
+struct weighted_status {
+   char const * stat;
+   unsigned     weight;
+};
+
+// Roughly the mix of a mature issues list: mostly closed issues, a sizable active list, and a few
+// issues in flight at a meeting.
+static weighted_status const status_mix[] {
+   {"New", 60}, {"Open", 60}, {"Review", 10}, {"Ready", 10}, {"Tentatively Ready", 8}, {"Deferred", 5},
+   {"LEWG", 5}, {"EWG", 3}, {"Core", 3}, {"Voting", 3}, {"Immediate", 2}, {"Pending WP", 3},
+   {"Tentatively NAD", 2}, {"WP", 60}, {"C++11", 60}, {"C++14", 30}, {"CD1", 100}, {"TC1", 40},
+   {"Resolved", 40}, {"NAD", 140}, {"Dup", 50}, {"NAD Future", 20}, {"NAD Editorial", 30}, {"NAD Concepts", 10}
+};
+
+static char const * const months[] {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+static char const * const words[] {
+   "the", "allocator", "shall", "iterator", "requirements", "container", "function", "template", "value",
+   "type", "undefined", "behavior", "throws", "exception", "effects", "returns", "complexity", "remarks",
+   "specialization", "constructor", "assignment", "operator", "range", "sequence", "argument", "library"
+};
+
+class corpus_generator {
+public:
+   corpus_generator(std::vector<lwg::section_tag> tags, unsigned issue_count)
+      : tags_(std::move(tags))
+      , issue_count_(issue_count)
+      , rng_(20140308u)
+   {
+      std::vector<double> weights;
+      for (auto const & s : status_mix) {
+         weights.push_back(s.weight);
+      }
+      status_dist_ = std::discrete_distribution<int>(weights.begin(), weights.end());
+   }
+
+   auto status() -> char const * { return status_mix[status_dist_(rng_)].stat; }
+
+   auto make_issue(int num, char const * stat, int resolution_paragraphs = 0) -> std::string {
+      // Resolution sizes vary from a sentence to several pages of wording, unless 'resolution_paragraphs' is given
+      std::ostringstream out;
+      out << "<?xml version='1.0' encoding='utf-8' standalone='no'?>\n"
+             "<!DOCTYPE issue SYSTEM \"lwg-issue.dtd\">\n\n"
+             "<issue num=\"" << num << "\" status=\"" << stat << "\">\n"
+             "<title>" << sentence(4, 10) << "</title>\n"
+             "<section>";
+      for (int n = pick(1, 4) == 1 ? 2 : 1; n != 0; --n) {
+         out << "<sref ref=\"" << tag() << "\"/>";
+      }
+      out << "</section>\n"
+             "<submitter>" << sentence(2, 2) << "</submitter>\n"
+             "<date>" << pick(1, 28) << ' ' << months[pick(0, 11)] << ' ' << pick(1998, 2014) << "</date>\n";
+      if (pick(0, 2) != 0) {
+         out << "<priority>" << pick(0, 4) << "</priority>\n";
+      }
+
+      out << "\n<discussion>\n";
+      for (int n = pick(1, 6); n != 0; --n) {
+         paragraph(out, num);
+      }
+      for (int n = pick(0, 2); n != 0; --n) {
+         out << "<note>" << pick(2005, 2014) << "-0" << pick(1, 9) << "-1" << pick(0, 9) << " " << sentence(3, 12) << "</note>\n";
+      }
+      if (std::string{"Dup"} == stat) {
+         out << "<duplicate><iref ref=\"" << other_issue(num) << "\"/></duplicate>\n";
+      }
+      out << "<!-- " << sentence(2, 6) << " -->\n"
+             "</discussion>\n\n"
+             "<resolution>\n";
+      if (resolution_paragraphs == 0) {
+         resolution_paragraphs = std::min(40, int(std::exponential_distribution<double>{0.4}(rng_)) + 1);
+      }
+      for (int n = resolution_paragraphs; n != 0; --n) {
+         paragraph(out, num);
+      }
+      out << "</resolution>\n\n"
+             "</issue>\n";
+      return out.str();
+   }
+
+private:
+   auto pick(int low, int high) -> int { return std::uniform_int_distribution<int>{low, high}(rng_); }
+
+   auto tag() -> lwg::section_tag {
+      // An occasional issue refers to a section that has since been removed from the standard
+      return pick(0, 99) == 0 ? "[removed.section." + std::to_string(pick(1, 50)) + "]" : tags_[pick(0, int(tags_.size()) - 1)];
+   }
+
+   auto other_issue(int num) -> int {
+      return issue_count_ < 2 ? num : (num + pick(1, int(issue_count_) - 1) - 1) % int(issue_count_) + 1;
+   }
+
+   auto sentence(int low, int high) -> std::string {
+      std::string result;
+      for (int n = pick(low, high); n != 0; --n) {
+         if (!result.empty()) {
+            result += ' ';
+         }
+         result += words[pick(0, sizeof(words) / sizeof(words[0]) - 1)];
+      }
+      return result;
+   }
+
+   void paragraph(std::ostream & out, int num) {
+      out << "<p>" << sentence(10, 40);
+      switch (pick(0, 5)) {
+         case 0: out << " (see <iref ref=\"" << other_issue(num) << "\"/>)"; break;
+         case 1: out << " in <sref ref=\"" << tag() << "\"/>"; break;
+         case 2: out << " <ins>" << sentence(2, 8) << "</ins> <del>" << sentence(2, 8) << "</del>"; break;
+         default: break;
+      }
+      out << ".</p>\n";
+   }
+
+   std::vector<lwg::section_tag>     tags_;
+   unsigned                          issue_count_;
+   std::mt19937                      rng_;
+   std::discrete_distribution<int>   status_dist_;
+};
+
+auto issue_filename(std::string const & path, int num) -> std::string {
+   std::ostringstream out;
+   out << path << "xml/issue" << std::setw(4) << std::setfill('0') << num << ".xml";
+   return out.str();
+}
+
+void write_file(std::string const & filename, std::string const & contents) {
+   std::ofstream out{filename};
+   if (!out) {
+      throw std::runtime_error{"Failed to open " + filename};
+   }
+   out << contents;
+}
+
+void make_directory(std::string const & path) {
+#if defined(_WIN32)
+   int const result = _mkdir(path.c_str());
+#else
+   int const result = mkdir(path.c_str(), 0777);
+#endif
+   if (result != 0  and  errno != EEXIST) {
+      throw std::runtime_error{"Unable to create directory " + path};
+   }
+}
+
+void remove_directory(std::string const & path) {
+#if defined(_WIN32)
+   _rmdir(path.c_str());
+#else
+   rmdir(path.c_str());
+#endif
+}
+
+auto make_scratch_directory(std::string const & work_path) -> std::string {
+   // Create a new, uniquely named, directory beneath 'work_path', and return its path
+   std::string path{work_path + "lwg-bench-XXXXXX"};
+#if defined(_WIN32)
+   if (_mktemp_s(&path[0], path.size() + 1) != 0  or  _mkdir(path.c_str()) != 0) {
+#else
+   if (mkdtemp(&path[0]) == nullptr) {
+#endif
+      throw std::runtime_error{"Unable to make a scratch directory beneath " + work_path};
+   }
+   return path + '/';
+}
+
+void write_corpus(std::string const & path, std::string const & section_data, unsigned issue_count) {
+   // Write a complete issues tree beneath 'path': the section index, a previous revision's TOC
+   // snapshot to diff against, the mailing information, and 'issue_count' issue files.
+   make_directory(path);
+   make_directory(path + "meta-data");
+   make_directory(path + "xml");
+   make_directory(path + "mailing");
+
+   write_file(path + "meta-data/section.data", section_data);
+
+   std::vector<lwg::section_tag> tags;
+   {
+      std::istringstream in{section_data};
+      for (auto const & elem : lwg::read_section_db(in)) {
+         tags.push_back(elem.first);
+      }
+   }
+   if (tags.empty()) {
+      throw std::runtime_error{"No sections in section.data"};
+   }
+
+   corpus_generator generator{tags, issue_count};
+   std::ostringstream old_toc;
+   old_toc << "# lwg-toc snapshot 1\n";
+   for (unsigned num = 1; num <= issue_count; ++num) {
+      char const * stat = generator.status();
+      write_file(issue_filename(path, num), generator.make_issue(num, stat));
+
+      // The previous revision lacks the newest issues, and a tenth of the others have since moved on
+      if (num <= issue_count - issue_count / 50) {
+         old_toc << num << '\t' << (num % 10 == 0 ? generator.status() : stat) << '\n';
+      }
+   }
+   write_file(path + "meta-data/lwg-toc.old.txt", old_toc.str());
+
+   write_file(path + "xml/lwg-issues.xml",
+R"(<?xml version='1.0' encoding='utf-8' standalone='no'?>
+<issueslist revision="R99" date="2014-03-08" title="Synthetic benchmark mailing"
+  active_docno="N9990" defect_docno="N9991" closed_docno="N9992"
+  maintainer="Benchmark Maintainer &lt;lwgchair@example.com&gt;">
+<intro list="Active"><p>Synthetic active issues list.</p></intro>
+<intro list="Defects"><p>Synthetic defect report list.</p></intro>
+<intro list="Closed"><p>Synthetic closed issues list.</p></intro>
+<statuses><p>Synthetic status descriptions.</p></statuses>
+<revision_history>
+<revision tag="R98">
+<p>Synthetic previous revision, moving <iref ref="1"/> forward.</p>
+</revision>
+</revision_history>
+</issueslist>
+)");
+}
+
+void remove_corpus(std::string const & path, unsigned issue_count) {
+   for (unsigned num = 1; num <= issue_count; ++num) {
+      std::remove(issue_filename(path, num).c_str());
+   }
+   for (auto file : {"xml/lwg-issues.xml", "meta-data/section.data", "meta-data/lwg-toc.old.txt"}) {
+      std::remove((path + file).c_str());
+   }
+   for (auto file : {"xml", "meta-data", "mailing"}) {
+      remove_directory(path + file);
+   }
+   remove_directory(path);
+}
+
+// Stage timing
+// ============
+
+auto file_size(std::string const & filename) -> double {
+   struct stat buf;
+   return stat(filename.c_str(), &buf) == 0 ? double(buf.st_size) : 0.0;
+}
+
+auto issue_files_size(std::string const & issues_path) -> double {
+   // Return the total size of the issue files in 'issues_path', as selected by 'read_issues'.
+   double total{0};
+   lwg::issue_directory const dir{issues_path};
+   for (auto const & file : dir.files()) {
+      total += file.size;
+   }
+   return total;
+}
+
+void report_stage(std::string const & stage, double seconds, std::size_t issue_count, double bytes) {
+   std::cout << "  " << std::left << std::setw(34) << stage << std::right
+             << std::fixed << std::setprecision(4) << std::setw(10) << seconds << " s"
+             << std::setprecision(0) << std::setw(14) << (seconds > 0 ? issue_count / seconds : 0) << " items/s";
+   if (bytes > 0) {
+      std::cout << std::setprecision(1) << std::setw(10) << (seconds > 0 ? bytes / seconds / 1e6 : 0) << " MB/s";
+   }
+   std::cout << std::endl;
+}
+
+template <typename Stage>
+auto time_stage(Stage stage) -> double {
+   auto const start = std::chrono::steady_clock::now();
+   stage();
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchmark_markup_scan(std::vector<lwg::issue> const & issues) {
+   // Count the '<' in the text of every issue: a byte at a time, as the formatter once did; from one '<'
+   // to the next with 'std::string::find', which is backed by 'memchr'; and with a 'markup_scanner', as
+   // the formatter does now, which classifies each block once and steps through the bits of its mask
+   double bytes{0};
+   for (auto const & iss : issues) {
+      bytes += iss.text.size();
+   }
+
+   std::size_t by_byte{0};
+   auto seconds = time_stage([&] {
+      for (auto const & iss : issues) {
+         for (char c : iss.text) {
+            by_byte += (c == '<');
+         }
+      }
+   });
+   report_stage("scan markup (byte at a time)", seconds, issues.size(), bytes);
+
+   std::size_t by_find{0};
+   seconds = time_stage([&] {
+      for (auto const & iss : issues) {
+         for (auto i = iss.text.find('<'); i != std::string::npos; i = iss.text.find('<', i + 1)) {
+            ++by_find;
+         }
+      }
+   });
+   report_stage("scan markup (std::string::find)", seconds, issues.size(), bytes);
+
+   std::size_t by_block{0};
+   seconds = time_stage([&] {
+      for (auto const & iss : issues) {
+         lwg::markup_scanner scanner{iss.text, lwg::open_angle};
+         for (auto i = scanner.next(0); i != std::string::npos; i = scanner.next(i + 1)) {
+            ++by_block;
+         }
+      }
+   });
+   report_stage("scan markup (block masks)", seconds, issues.size(), bytes);
+
+   if (by_byte != by_find  or  by_byte != by_block) {
+      throw std::runtime_error{"Markup scans disagree"};
+   }
+}
+
+void benchmark_large_issue(std::string const & section_data) {
+   // A single issue with megabytes of proposed wording, far larger than any real issue, so that the cost of
+   // scanning its markup outweighs the fixed cost of handling an issue at all
+   lwg::section_map section_db;
+   {
+      std::istringstream in{section_data};
+      section_db = lwg::read_section_db(in);
+   }
+   std::vector<lwg::section_tag> tags;
+   for (auto const & elem : section_db) {
+      tags.push_back(elem.first);
+   }
+
+   corpus_generator generator{tags, 1};
+   auto const text = generator.make_issue(1, "Open", 20000);
+
+   std::vector<lwg::issue> issues;
+   auto seconds = time_stage([&] { issues.push_back(lwg::parse_issue_from_file(text, "large issue", gregorian::date{}, section_db)); });
+   report_stage("parse large issue", seconds, 1, static_cast<double>(text.size()));
+
+   lwg::section_index const sections{section_db};
+   seconds = time_stage([&] { lwg::prepare_issues(issues, sections); });
+   report_stage("format large issue", seconds, 1, static_cast<double>(text.size()));
+}
+
+void benchmark_corpus(std::string const & path, std::string const & target_path) {
+   // Run, and time, each stage of the 'lists' program over the issues tree at 'path', writing the
+   // documents to the directory 'target_path', and removing them once measured.
+
+   lwg::section_map section_db;
+   auto seconds = time_stage([&] { section_db = lwg::load_section_db(path + "meta-data/"); });
+   report_stage("read_section_db", seconds, section_db.size(), file_size(path + "meta-data/section.data"));
+
+   std::vector<lwg::issue> issues;
+   seconds = time_stage([&] { issues = lwg::read_issues(path + "xml/", section_db); });
+   report_stage("read_issues", seconds, issues.size(), issue_files_size(path + "xml/"));
+
+   // As 'list_issues' reads them, for the number and status alone
+   std::size_t headers_read{0};
+   seconds = time_stage([&] {
+      lwg::issue_directory const dir{path + "xml/"};
+      lwg::section_map unused;
+      for (auto const & file : dir.files()) {
+         auto const iss = lwg::parse_issue_fields(dir.read(file), file.name, lwg::issue_number | lwg::issue_status, unused);
+         headers_read += !iss.stat.empty();
+      }
+   });
+   report_stage("read issue number and status", seconds, headers_read, issue_files_size(path + "xml/"));
+
+   lwg::section_index sections;
+   seconds = time_stage([&] { sections = lwg::section_index{section_db}; });
+   report_stage("freeze section index", seconds, sections.size(), 0);
+
+   lwg::reference_graph references;
+   seconds = time_stage([&] { references = lwg::prepare_issues(issues, sections); });
+   report_stage("prepare_issues", seconds, issues.size(), 0);
+   benchmark_markup_scan(issues);
+
+   std::ifstream mailing_file{path + "xml/lwg-issues.xml"};
+   if (!mailing_file.is_open()) {
+      throw std::runtime_error{"Unable to open " + path + "xml/lwg-issues.xml"};
+   }
+   lwg::mailing_info lwg_issues_xml{mailing_file};
+
+   std::string diff_report;
+   seconds = time_stage([&] {
+      auto const old_issues = lwg::load_toc_snapshot(path + "meta-data/lwg-toc.old.html");
+      std::ostringstream os_diff_report;
+      lwg::print_current_revisions(os_diff_report, old_issues, lwg::make_toc_snapshot(issues));
+      diff_report = os_diff_report.str();
+   });
+   report_stage("revision diff", seconds, issues.size(), 0);
+
+   lwg::issue_table all_issues;
+   seconds = time_stage([&] { all_issues = lwg::make_issue_table(issues, sections); });
+   report_stage("make_issue_table", seconds, issues.size(), 0);
+
+   auto const unresolved_issues = lwg::select_by_status(all_issues, [](std::string const & stat){ return lwg::is_not_resolved(stat); } );
+
+   lwg::report_generator generator{lwg_issues_xml, sections, references};
+
+   struct document {
+      char const *                  stage;
+      char const *                  filename;
+      std::function<void()>         make;
+   };
+
+   std::vector<document> const documents {
+      {"make_active",                  "lwg-active.html",              [&]{ generator.make_active(issues, target_path, diff_report); }},
+      {"make_defect",                  "lwg-defects.html",             [&]{ generator.make_defect(issues, target_path, diff_report); }},
+      {"make_closed",                  "lwg-closed.html",              [&]{ generator.make_closed(issues, target_path, diff_report); }},
+      {"make_tentative",               "lwg-tentative.html",           [&]{ generator.make_tentative(issues, target_path); }},
+      {"make_unresolved",              "lwg-unresolved.html",          [&]{ generator.make_unresolved(issues, target_path); }},
+      {"make_immediate",               "lwg-immediate.html",           [&]{ generator.make_immediate(issues, target_path); }},
+      {"make_editors_issues",          "lwg-issues-for-editor.html",   [&]{ generator.make_editors_issues(issues, target_path); }},
+      {"make_sort_by_num",             "lwg-toc.html",                 [&]{ generator.make_sort_by_num(all_issues, target_path + "lwg-toc.html"); }},
+      {"make_sort_by_status",          "lwg-status.html",              [&]{ generator.make_sort_by_status(all_issues, target_path + "lwg-status.html"); }},
+      {"make_sort_by_status_mod_date", "lwg-status-date.html",         [&]{ generator.make_sort_by_status_mod_date(all_issues, target_path + "lwg-status-date.html"); }},
+      {"make_sort_by_section",         "lwg-index.html",               [&]{ generator.make_sort_by_section(all_issues, target_path + "lwg-index.html"); }},
+      {"make_sort_by_section (open)",  "lwg-index-open.html",          [&]{ generator.make_sort_by_section(all_issues, target_path + "lwg-index-open.html", true); }},
+      {"make_sort_by_priority",        "unresolved-prioritized.html",  [&]{ generator.make_sort_by_priority(unresolved_issues, target_path + "unresolved-prioritized.html"); }},
+   };
+
+   double document_bytes{0};
+   for (auto const & doc : documents) {
+      seconds = time_stage(doc.make);
+      auto const bytes = file_size(target_path + doc.filename);
+      report_stage(doc.stage, seconds, issues.size(), bytes);
+      document_bytes += bytes;
+   }
+
+   lwg::compression_formats gzip;
+   gzip.gzip = true;
+   seconds = time_stage([&] { generator.compress_documents(gzip); });
+   report_stage("compress documents (gzip)", seconds, documents.size(), document_bytes);
+
+   for (auto const & doc : documents) {
+      std::remove((target_path + doc.filename).c_str());
+      std::remove((target_path + doc.filename + ".gz").c_str());
+   }
+
+   // The exports are written to memory, so that only the cost of formatting is measured
+   std::ostringstream json;
+   seconds = time_stage([&] { lwg::write_issues_json_lines(json, issues, sections, true); });
+   report_stage("export json lines (with text)", seconds, issues.size(), static_cast<double>(json.str().size()));
+
+   std::ostringstream csv;
+   seconds = time_stage([&] { lwg::write_issues_csv(csv, issues, sections); });
+   report_stage("export csv", seconds, issues.size(), static_cast<double>(csv.str().size()));
+}
+
+} // close unnamed namespace
+
+// ============================================================================================================
+
+int main(int argc, char const * argv[]) {
+   try {
+      std::string work_path;
+      if (char const * tmpdir = std::getenv("TMPDIR")) {
+         work_path = tmpdir;
+      }
+      else {
+         work_path = "/tmp";
+      }
+      std::string corpus_path;
+      bool keep{false};
+      std::vector<unsigned> counts;
+
+      for (int i{1}; i < argc; ++i) {
+         std::string const arg{argv[i]};
+         if (arg == "--work"  and  i + 1 < argc) {
+            work_path = argv[++i];
+         }
+         else if (arg == "--corpus"  and  i + 1 < argc) {
+            corpus_path = argv[++i];
+         }
+         else if (arg == "--keep") {
+            keep = true;
+         }
+         else {
+            counts.push_back(std::stoul(arg));
+         }
+      }
+
+      if (!corpus_path.empty()) {
+         if (corpus_path.back() != '/') { corpus_path += '/'; }
+         if (work_path.back() != '/') { work_path += '/'; }
+         auto const scratch = make_scratch_directory(work_path);
+         std::cout << "Benchmarking issues in " << corpus_path << ", writing documents to " << scratch << std::endl;
+         benchmark_corpus(corpus_path, scratch);
+         remove_directory(scratch);
+         return 0;
+      }
+
+      if (counts.empty()) {
+         counts = {10000, 100000, 1000000};
+      }
+      if (work_path.back() != '/') { work_path += '/'; }
+
+      auto const section_data = lwg::read_file_into_string("meta-data/section.data");
+
+      for (auto count : counts) {
+         auto const path = work_path + "lwg-bench-" + std::to_string(count) + "/";
+         std::cout << "Generating " << count << " issues in " << path << std::endl;
+         auto const seconds = time_stage([&] { write_corpus(path, section_data, count); });
+         report_stage("generate corpus", seconds, count, 0);
+
+         benchmark_corpus(path, path + "mailing/");
+         benchmark_large_issue(section_data);
+
+         if (!keep) {
+            remove_corpus(path, count);
+         }
+      }
+   }
+   catch(std::exception const & ex) {
+      std::cout << ex.what() << std::endl;
+      return 1;
+   }
+}
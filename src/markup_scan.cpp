@@ -0,0 +1,195 @@
+#include "markup_scan.h"
+
+#include <cassert>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LWG_SCAN_AVX2
+#define LWG_SCAN_SSE2
+#elif defined(__SSE2__)  ||  defined(_M_X64)  ||  (defined(_M_IX86_FP)  &&  _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LWG_SCAN_SSE2
+#endif
+
+#if defined(LWG_SCAN_SSE2)  &&  defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+#if defined(LWG_SCAN_SSE2)
+auto lowest_bit(unsigned mask) noexcept -> unsigned {
+   // Position of the lowest set bit of a non-zero 'mask'
+#if defined(_MSC_VER)
+   unsigned long index;
+   _BitScanForward(&index, mask);
+   return static_cast<unsigned>(index);
+#else
+   return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+#if defined(LWG_SCAN_AVX2)
+std::size_t const block_size{32};
+
+auto block_mask(char const * block, char wanted) noexcept -> unsigned {
+   // One bit for each of the 32 bytes at 'block' that equals 'wanted'
+   __m256i const bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(block));
+   return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(wanted))));
+}
+#elif defined(LWG_SCAN_SSE2)
+std::size_t const block_size{16};
+
+auto block_mask(char const * block, char wanted) noexcept -> unsigned {
+   // One bit for each of the 16 bytes at 'block' that equals 'wanted'
+   __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(block));
+   return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(wanted))));
+}
+#endif
+
+auto single_char(unsigned chars) noexcept -> char {
+   // The character named by 'chars', if it names exactly one, and otherwise '\0'
+   switch (chars) {
+      case lwg::open_angle  : return '<';
+      case lwg::close_angle : return '>';
+      case lwg::quote       : return '"';
+      default               : return '\0';
+   }
+}
+
+struct wanted_chars {
+   // The characters to find, as three comparands.  A set of fewer than three characters repeats one of
+   // them, so every block is compared three times, without a branch on the set.
+   explicit wanted_chars(unsigned chars) noexcept {
+      char found[3];
+      int n{0};
+      if (chars & lwg::open_angle)  { found[n++] = '<'; }
+      if (chars & lwg::close_angle) { found[n++] = '>'; }
+      if (chars & lwg::quote)       { found[n++] = '"'; }
+      assert(n > 0);
+      a = found[0];
+      b = n > 1 ? found[1] : found[0];
+      c = n > 2 ? found[2] : found[0];
+   }
+
+   auto operator()(char x) const noexcept -> bool { return x == a  or  x == b  or  x == c; }
+
+   char a, b, c;
+};
+
+} // close unnamed namespace
+
+
+auto lwg::find_markup(char const * first, char const * last, unsigned chars) noexcept -> char const * {
+   if (chars == 0) {
+      return last;
+   }
+   wanted_chars const wanted{chars};
+
+#if defined(LWG_SCAN_AVX2)
+   __m256i const a32 = _mm256_set1_epi8(wanted.a);
+   __m256i const b32 = _mm256_set1_epi8(wanted.b);
+   __m256i const c32 = _mm256_set1_epi8(wanted.c);
+   for (; last - first >= 32; first += 32) {
+      __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(first));
+      __m256i const hits  = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, a32), _mm256_cmpeq_epi8(block, b32)),
+                                            _mm256_cmpeq_epi8(block, c32));
+      auto const mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+      if (mask != 0) {
+         return first + lowest_bit(mask);
+      }
+   }
+#endif
+
+#if defined(LWG_SCAN_SSE2)
+   __m128i const a16 = _mm_set1_epi8(wanted.a);
+   __m128i const b16 = _mm_set1_epi8(wanted.b);
+   __m128i const c16 = _mm_set1_epi8(wanted.c);
+   for (; last - first >= 16; first += 16) {
+      __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(first));
+      __m128i const hits  = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, a16), _mm_cmpeq_epi8(block, b16)),
+                                         _mm_cmpeq_epi8(block, c16));
+      auto const mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+      if (mask != 0) {
+         return first + lowest_bit(mask);
+      }
+   }
+#endif
+
+   // The tail, shorter than a block, or the whole range where there are no vector instructions
+   for (; first != last; ++first) {
+      if (wanted(*first)) {
+         return first;
+      }
+   }
+   return last;
+}
+
+
+auto lwg::find_markup(std::string const & text, std::string::size_type pos, unsigned chars) noexcept -> std::string::size_type {
+   if (pos >= text.size()) {
+      return std::string::npos;
+   }
+   if (char const c = single_char(chars)) {
+      return text.find(c, pos);
+   }
+   auto const first = text.data();
+   auto const last  = first + text.size();
+   auto const found = find_markup(first + pos, last, chars);
+   return found == last ? std::string::npos : static_cast<std::string::size_type>(found - first);
+}
+
+
+auto lwg::find_markup_tag(std::string const & text, char const * tag, std::string::size_type pos) noexcept -> std::string::size_type {
+   assert(tag[0] == '<');
+   auto const length = std::strlen(tag);
+   for (pos = find_markup(text, pos, open_angle); pos != std::string::npos; pos = find_markup(text, pos + 1, open_angle)) {
+      if (text.compare(pos, length, tag) == 0) {
+         return pos;
+      }
+   }
+   return std::string::npos;
+}
+
+
+lwg::markup_scanner::markup_scanner(std::string const & text, markup_char wanted) noexcept
+   : text_{&text}
+   , wanted_{single_char(wanted)}
+   , block_{std::string::npos}
+   , mask_{0}
+   {
+   assert(wanted_ != '\0');
+}
+
+auto lwg::markup_scanner::next(std::string::size_type pos) noexcept -> std::string::size_type {
+#if defined(LWG_SCAN_SSE2)
+   // The bits of the current block from 'pos' onwards, if 'pos' lies within it
+   if (block_ != std::string::npos  and  block_ <= pos  and  pos - block_ < block_size) {
+      auto const later = mask_ & (~0u << (pos - block_));
+      if (later != 0) {
+         return block_ + lowest_bit(later);
+      }
+      pos = block_ + block_size;
+   }
+
+   auto const size = text_->size();
+   auto const data = text_->data();
+   for (; pos < size  and  size - pos >= block_size; pos += block_size) {
+      auto const mask = block_mask(data + pos, wanted_);
+      if (mask != 0) {
+         block_ = pos;
+         mask_ = mask;
+         return pos + lowest_bit(mask);
+      }
+   }
+   block_ = std::string::npos;
+#endif
+   // The tail, shorter than a block, or the whole text where there are no vector instructions
+   return pos < text_->size() ? text_->find(wanted_, pos) : std::string::npos;
+}
+
+void lwg::markup_scanner::reset() noexcept {
+   block_ = std::string::npos;
+}
@@ -0,0 +1,61 @@
+#ifndef INCLUDE_LWG_MARKUP_SCAN_H
+#define INCLUDE_LWG_MARKUP_SCAN_H
+
+// Scanning text for the characters that give the issue markup its structure, '<', '>' and '"', a block
+// at a time rather than a byte at a time.  Each block of text is compared against every wanted character
+// at once, and the matches are gathered into a bitmask with one bit per byte.  A 'markup_scanner' keeps
+// the mask of its current block and steps through its set bits, so each block is classified only once,
+// however many of the wanted characters it holds.  Blocks are 32 bytes where the compiler targets AVX2
+// (for example, with '-mavx2'), and 16 bytes with SSE2, which every x86-64 compiler targets.  Other
+// platforms fall back on a byte at a time.
+//
+// A search for a single character, from a position, is left to 'std::string::find', which the standard
+// libraries implement with 'memchr', and which a block-at-a-time search that keeps no mask cannot beat.
+
+#include <cstddef>
+#include <string>
+
+namespace lwg
+{
+
+enum markup_char : unsigned {
+   open_angle  = 1u,  // '<'
+   close_angle = 2u,  // '>'
+   quote       = 4u,  // '"'
+};
+
+auto find_markup(char const * first, char const * last, unsigned chars) noexcept -> char const *;
+   // Return the first position in [first, last) that holds one of 'chars', a combination of 'markup_char'
+   // values, or 'last' if there is none.
+
+auto find_markup(std::string const & text, std::string::size_type pos, unsigned chars) noexcept -> std::string::size_type;
+   // Return the first position in 'text', from 'pos', that holds one of 'chars', or 'npos' if there is none,
+   // as by 'text.find_first_of'.  A single character is found by 'text.find'.
+
+auto find_markup_tag(std::string const & text, char const * tag, std::string::size_type pos) noexcept -> std::string::size_type;
+   // Return the first position in 'text', from 'pos', where 'tag', which must begin with '<', is found, or
+   // 'npos' if there is none, as by 'text.find', stepping from one '<' to the next.
+
+class markup_scanner {
+public:
+   markup_scanner(std::string const & text, markup_char wanted) noexcept;
+      // Prepare to find each position of the character 'wanted' in 'text', which must outlive the scanner.
+
+   auto next(std::string::size_type pos) noexcept -> std::string::size_type;
+      // Return the first position in the text, from 'pos', that holds the wanted character, or 'npos' if
+      // there is none.  A position within the block last classified is found from its mask, without
+      // reading the text again.
+
+   void reset() noexcept;
+      // Forget the block last classified.  Call after modifying the text, before the next call to 'next'.
+
+private:
+   std::string const *      text_;
+   char                     wanted_;
+   std::string::size_type   block_;  // start of the block last classified, or 'npos'
+   unsigned                 mask_;   // one bit for each byte of that block holding 'wanted_'
+};
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_MARKUP_SCAN_H
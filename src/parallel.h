@@ -0,0 +1,62 @@
+#ifndef INCLUDE_LWG_PARALLEL_H
+#define INCLUDE_LWG_PARALLEL_H
+
+// A loop run across every hardware thread, for stages whose items are independent of one another.
+// Programs using it must be built with '-pthread'.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lwg
+{
+
+template <typename Function>
+void parallel_for(std::size_t count, Function f);
+   // Call 'f(i)' for each 'i' in '[0, count)', on as many threads as the hardware supports, the calling
+   // thread among them.  The items may differ widely in cost, so each thread takes the next index as it
+   // finishes one, rather than a fixed share.  If any call throws, the remaining items are still visited,
+   // and the first exception is rethrown once every thread has stopped.
+
+
+template <typename Function>
+void parallel_for(std::size_t count, Function f) {
+   std::atomic<std::size_t> next{0};
+   std::exception_ptr failure;
+   std::mutex failure_lock;
+   auto worker = [&]() {
+      for (auto i = next++; i < count; i = next++) {
+         try {
+            f(i);
+         }
+         catch (...) {
+            std::lock_guard<std::mutex> lock{failure_lock};
+            if (!failure) {
+               failure = std::current_exception();
+            }
+         }
+      }
+   };
+
+   auto const thread_count = std::min<std::size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+   std::vector<std::thread> threads;
+   for (std::size_t i{1}; i < thread_count; ++i) {
+      threads.emplace_back(worker);
+   }
+   worker();
+   for (auto & t : threads) {
+      t.join();
+   }
+
+   if (failure) {
+      std::rethrow_exception(failure);
+   }
+}
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_PARALLEL_H
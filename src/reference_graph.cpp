@@ -0,0 +1,70 @@
+#include "reference_graph.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+using edge = std::pair<int, int>;
+
+void fill_adjacency(std::vector<edge> const & edges, int max_num, std::vector<std::uint32_t> & offsets, std::vector<int> & targets) {
+   // 'edges' must be sorted, and free of repeats, so each run of targets is filled in ascending order
+   offsets.assign(static_cast<std::size_t>(max_num) + 2, 0);
+   for (auto const & e : edges) {
+      ++offsets[static_cast<std::size_t>(e.first) + 1];
+   }
+   for (std::size_t n{1}; n < offsets.size(); ++n) {
+      offsets[n] += offsets[n - 1];
+   }
+
+   targets.clear();
+   targets.reserve(edges.size());
+   for (auto const & e : edges) {
+      targets.push_back(e.second);
+   }
+}
+
+} // close unnamed namespace
+
+
+lwg::reference_graph::reference_graph(std::vector<issue_reference> references) {
+   std::vector<edge> edges;
+   edges.reserve(references.size());
+   int max_num{0};
+   for (auto const & ref : references) {
+      if (ref.from != ref.to  and  ref.from >= 0  and  ref.to >= 0) {
+         edges.emplace_back(ref.from, ref.to);
+         max_num = std::max({max_num, ref.from, ref.to});
+      }
+   }
+   references.clear();
+
+   std::sort(edges.begin(), edges.end());
+   edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+   fill_adjacency(edges, max_num, forward_.offsets, forward_.targets);
+
+   for (auto & e : edges) {
+      std::swap(e.first, e.second);
+   }
+   std::sort(edges.begin(), edges.end());
+   fill_adjacency(edges, max_num, reverse_.offsets, reverse_.targets);
+}
+
+
+auto lwg::reference_graph::adjacency::operator()(int num) const noexcept -> issue_numbers {
+   if (num < 0  or  static_cast<std::size_t>(num) + 1 >= offsets.size()) {
+      return issue_numbers{nullptr, nullptr};
+   }
+   auto const base = targets.data();
+   return issue_numbers{base + offsets[static_cast<std::size_t>(num)], base + offsets[static_cast<std::size_t>(num) + 1]};
+}
+
+
+auto lwg::reference_graph::references(int num) const noexcept -> issue_numbers {
+   return forward_(num);
+}
+
+
+auto lwg::reference_graph::referenced_by(int num) const noexcept -> issue_numbers {
+   return reverse_(num);
+}
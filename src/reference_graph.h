@@ -0,0 +1,69 @@
+#ifndef INCLUDE_LWG_REFERENCE_GRAPH_H
+#define INCLUDE_LWG_REFERENCE_GRAPH_H
+
+// The cross-references between issues, as found by the '<iref>' elements in their text while they are
+// formatted.  The graph is held in compressed sparse row form, in each direction: the issues that each
+// issue refers to, and the issues that refer to it, are runs in a single array, found through an array of
+// offsets indexed by issue number.  Issue numbers are dense, so the offset arrays need no lookup of their
+// own, and either question is answered in constant time.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lwg
+{
+
+struct issue_reference {
+   int   from;       // number of the issue whose text holds the reference
+   int   to;         // number of the issue referred to
+   bool  duplicate;  // 'true' if the reference, within a '<duplicate>', marks the two issues as duplicates
+};
+
+class issue_numbers {
+   // A view of a run of issue numbers, in ascending order, within a 'reference_graph'.
+public:
+   issue_numbers(int const * first, int const * last) noexcept : first_{first}, last_{last} {}
+
+   auto begin() const noexcept -> int const * { return first_; }
+   auto end() const noexcept -> int const * { return last_; }
+   auto size() const noexcept -> std::size_t { return static_cast<std::size_t>(last_ - first_); }
+   auto empty() const noexcept -> bool { return first_ == last_; }
+
+private:
+   int const * first_;
+   int const * last_;
+};
+
+class reference_graph {
+public:
+   reference_graph() = default;
+
+   explicit reference_graph(std::vector<issue_reference> references);
+      // Record every reference in 'references'.  Repeated references between the same two issues are
+      // recorded once, and an issue referring to itself is not recorded.
+
+   auto references(int num) const noexcept -> issue_numbers;
+      // Return the issues that issue 'num' refers to, in ascending order.
+
+   auto referenced_by(int num) const noexcept -> issue_numbers;
+      // Return the issues that refer to issue 'num', in ascending order.
+
+   auto size() const noexcept -> std::size_t { return forward_.targets.size(); }
+      // Return the number of distinct references between issues.
+
+private:
+   struct adjacency {
+      std::vector<std::uint32_t>  offsets;  // run of 'targets' for issue number 'n' is [offsets[n], offsets[n+1])
+      std::vector<int>            targets;  // every issue number at the far end of a reference
+
+      auto operator()(int num) const noexcept -> issue_numbers;
+   };
+
+   adjacency  forward_;  // from each issue to those it refers to
+   adjacency  reverse_;  // from each issue to those that refer to it
+};
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_REFERENCE_GRAPH_H
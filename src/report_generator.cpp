@@ -1,16 +1,32 @@
 #include "report_generator.h"
 
+#include "compressed_files.h"
 #include "mailing_info.h"
+#include "parallel.h"
 #include "sections.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <ctime>
 #include <fstream>
 #include <functional>  // reference_wrapper
+#include <iterator>
+#include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 
+// platform headers
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
 namespace
 {
 
@@ -31,82 +47,91 @@ auto format_time(std::string const & format, std::tm const & t) -> std::string {
    return s;
 }
 
-auto utc_timestamp() -> std::tm const & {
-   static std::time_t t{ std::time(nullptr) };
-   static std::tm utc = *std::gmtime(&t);
-   return utc;
-}
-
-// global data - would like to do something about that.
-static std::string const build_timestamp{format_time("<p>Revised %Y-%m-%d at %H:%m:%S UTC</p>\n", utc_timestamp())};
-
+auto write_if_changed(std::string const & filename, std::string const & contents) -> bool {
+   // Compare with the existing file, read in the same text mode that it was written in, and leave the file
+   // untouched if it already holds 'contents'.  Return 'true' if the file was written.
+   {
+      std::ifstream existing{filename};
+      if (existing.is_open()) {
+         std::istreambuf_iterator<char> first{existing}, last{};
+         auto i = contents.begin();
+         auto const e = contents.end();
+         for (; first != last  and  i != e  and  *first == *i; ++first, ++i) {
+         }
+         if (first == last  and  i == e) {
+            return false;
+         }
+      }
+   }
 
-struct order_by_first_tag {
-   bool operator()(lwg::issue const & x, lwg::issue const & y) const noexcept {
-      assert(!x.tags.empty());
-      assert(!y.tags.empty());
-      return x.tags.front() < y.tags.front();
+   std::ofstream out{filename.c_str()};
+   if (!out.write(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+      throw std::runtime_error{"Failed to write " + filename};
    }
-};
+   return true;
+}
+
 
 struct order_by_major_section {
-   explicit order_by_major_section(lwg::section_map & sections) 
-      : section_db(sections)
+   explicit order_by_major_section(lwg::issue_table const & issues)
+      : table(issues)
       {
       }
 
-   auto operator()(lwg::issue const & x, lwg::issue const & y) const -> bool {
-assert(!x.tags.empty());
-assert(!y.tags.empty());
-      lwg::section_num const & xn = section_db.get()[x.tags[0]];
-      lwg::section_num const & yn = section_db.get()[y.tags[0]];
+   auto operator()(lwg::issue_row x, lwg::issue_row y) const -> bool {
+      lwg::section_num const & xn = table.get().section_of(x);
+      lwg::section_num const & yn = table.get().section_of(y);
       return  xn.prefix < yn.prefix
           or (xn.prefix > yn.prefix  and  xn.num[0] < yn.num[0]);
    }
 
 private:
-   std::reference_wrapper<lwg::section_map> section_db;
+   std::reference_wrapper<lwg::issue_table const> table;
 };
 
-struct order_by_section {
-   explicit order_by_section(lwg::section_map &sections) 
-      : section_db(sections)
-      {
-      }
 
-   auto operator()(lwg::issue const & x, lwg::issue const & y) const -> bool {
-      assert(!x.tags.empty());
-      assert(!y.tags.empty());
-      return section_db.get()[x.tags.front()] < section_db.get()[y.tags.front()];
-   }
+// Orderings of the rows of an 'issue_table', comparing its hot columns only
+struct order_rows_by_issue_number {
+   lwg::issue_table const & table;
 
-private:
-   std::reference_wrapper<lwg::section_map> section_db;
+   auto operator()(lwg::issue_row x, lwg::issue_row y) const noexcept -> bool {
+      return table.num[x] < table.num[y];
+   }
 };
 
-struct order_by_status {
-   auto operator()(lwg::issue const & x, lwg::issue const & y) const noexcept -> bool {
-      return lwg::get_status_priority(x.stat) < lwg::get_status_priority(y.stat);
+struct order_rows_by_section {
+   lwg::issue_table const & table;
+
+   auto operator()(lwg::issue_row x, lwg::issue_row y) const noexcept -> bool {
+      return table.section[x] < table.section[y];
    }
 };
 
+struct order_rows_by_status {
+   lwg::issue_table const & table;
 
-struct order_by_priority {
-   explicit order_by_priority(lwg::section_map &sections) 
-      : section_db(sections)
-      {
-      }
+   auto operator()(lwg::issue_row x, lwg::issue_row y) const noexcept -> bool {
+      return table.status_priority[x] < table.status_priority[y];
+   }
+};
 
-   auto operator()(lwg::issue const & x, lwg::issue const & y) const -> bool {
-      assert(!x.tags.empty());
-      assert(!y.tags.empty());
-      return x.priority == y.priority
-           ? section_db.get()[x.tags.front()] < section_db.get()[y.tags.front()]
-           : x.priority < y.priority;
+struct order_rows_by_mod_date_descending {
+   lwg::issue_table const & table;
+
+   auto operator()(lwg::issue_row x, lwg::issue_row y) const noexcept -> bool {
+      return table.mod_date[x] > table.mod_date[y];
    }
+};
 
-private:
-   std::reference_wrapper<lwg::section_map> section_db;
+struct order_rows_by_priority {
+   // Issues of equal priority are ordered by section, and then by number, so the order is fully determined.
+   lwg::issue_table const & table;
+
+   auto operator()(lwg::issue_row x, lwg::issue_row y) const noexcept -> bool {
+      return table.priority[x] != table.priority[y] ? table.priority[x] < table.priority[y]
+           : table.section[x]  != table.section[y]  ? table.section[x]  < table.section[y]
+           :                                          table.num[x]      < table.num[y];
+   }
 };
 
 
@@ -133,6 +158,35 @@ auto remove_square_brackets(lwg::section_tag const & tag) -> lwg::section_tag {
 }
 
 
+auto issue_page_filename(int num) -> std::string {
+   // Relative to the directory of the published documents
+   return "issues/" + std::to_string(num) + ".html";
+}
+
+auto section_page_filename(lwg::section_tag const & tag) -> std::string {
+   // Relative to the directory of the published documents.  Tags are dotted names, such as '[tr.util.refwrp]',
+   // so any character that may not be safe in a file name is replaced.
+   std::string name{remove_square_brackets(tag)};
+   for (auto & c : name) {
+      if (!std::isalnum(static_cast<unsigned char>(c))  and  c != '.'  and  c != '-'  and  c != '_') {
+         c = '_';
+      }
+   }
+   return "sections/" + name + ".html";
+}
+
+void make_directory(std::string const & path) {
+#if defined(_WIN32)
+   int const result = _mkdir(path.c_str());
+#else
+   int const result = mkdir(path.c_str(), 0777);
+#endif
+   if (result != 0  and  errno != EEXIST) {
+      throw std::runtime_error{"Unable to create directory " + path};
+   }
+}
+
+
 void print_date(std::ostream & out, gregorian::date const & mod_date ) {
    out << mod_date.year() << '-';
    if (mod_date.month() < 10) { out << '0'; }
@@ -152,14 +206,20 @@ void print_list(std::ostream & out, Container const & source, char const * separ
 
 
 
-void print_file_header(std::ostream& out, std::string const & title) {
+void print_file_header(std::ostream& out, std::string const & title, std::string const & base = {}) {
+   // A page written below the directory of the published documents passes that directory as 'base', so that
+   // every relative link in the page, including those within the text of the issues, resolves against it.
    out <<
 R"(<!DOCTYPE HTML PUBLIC "-//W3C//DTD HTML 4.01//EN"
     "http://www.w3.org/TR/html4/strict.dtd">
 <html>
 <head>
 <title>)" << title << R"(</title>
-<style type="text/css">
+)";
+   if (!base.empty()) {
+      out << "<base href=\"" << base << "\">\n";
+   }
+   out << R"(<style type="text/css">
   p {text-align:justify}
   li {text-align:justify}
   blockquote.note
@@ -186,7 +246,7 @@ void print_file_trailer(std::ostream& out) {
 }
 
 
-void print_table(std::ostream& out, std::vector<lwg::issue>::const_iterator i, std::vector<lwg::issue>::const_iterator e, lwg::section_map & section_db) {
+void print_table(std::ostream& out, lwg::issue_table const & table, std::vector<lwg::issue_row>::const_iterator i, std::vector<lwg::issue_row>::const_iterator e, lwg::section_index const & section_db, bool link_issue_pages) {
 #if defined (DEBUG_LOGGING)
    std::cout << "\t" << std::distance(i,e) << " items to add to table" << std::endl;
 #endif
@@ -206,30 +266,38 @@ R"(<table border="1" cellpadding="4">
 
    std::string prev_tag;
    for (; i != e; ++i) {
+      lwg::issue const & iss = table[*i];
       out << "<tr>\n";
 
-      // Number
-      out << "<td align=\"right\">" << make_html_anchor(*i) << "</td>\n";
+      // Number, linked to the page of its own if there is one
+      out << "<td align=\"right\">";
+      if (link_issue_pages) {
+         out << "<a href=\"" << issue_page_filename(iss.num) << "\">" << iss.num << "</a>";
+      }
+      else {
+         out << make_html_anchor(iss);
+      }
+      out << "</td>\n";
 
       // Status
-      out << "<td align=\"left\"><a href=\"lwg-active.html#" << lwg::remove_qualifier(i->stat) << "\">" << i->stat << "</a><a name=\"" << i->num << "\"></a></td>\n";
+      out << "<td align=\"left\"><a href=\"lwg-active.html#" << lwg::remove_qualifier(iss.stat) << "\">" << iss.stat << "</a><a name=\"" << iss.num << "\"></a></td>\n";
 
       // Section
       out << "<td align=\"left\">";
-assert(!i->tags.empty());
-      out << section_db[i->tags[0]] << " " << i->tags[0];
-      if (i->tags[0] != prev_tag) {
-         prev_tag = i->tags[0];
+assert(!iss.tags.empty());
+      out << section_db.label(iss.tags[0]) << " " << iss.tags[0];
+      if (iss.tags[0] != prev_tag) {
+         prev_tag = iss.tags[0];
          out << "<a name=\"" << remove_square_brackets(prev_tag) << "\"</a>";
       }
       out << "</td>\n";
 
       // Title
-      out << "<td align=\"left\">" << i->title << "</td>\n";
+      out << "<td align=\"left\">" << iss.title << "</td>\n";
 
       // Has Proposed Resolution
       out << "<td align=\"center\">";
-      if (i->has_resolution) {
+      if (iss.has_resolution) {
          out << "Yes";
       }
       else {
@@ -239,108 +307,159 @@ assert(!i->tags.empty());
 
       // Priority
       out << "<td align=\"center\">";
-      if (i->priority != 99) {
-         out << i->priority;
+      if (iss.priority != 99) {
+         out << iss.priority;
       }
       out << "</td>\n";
 
       // Duplicates
       out << "<td align=\"left\">";
-      print_list(out, i->duplicates, ", ");
+      print_list(out, iss.duplicates, ", ");
       out << "</td>\n"
           << "</tr>\n";
    }
    out << "</table>\n";
 }
 
-template <typename Pred>
-void print_issues(std::ostream & out, std::vector<lwg::issue> const & issues, lwg::section_map & section_db, Pred pred) {
-   std::multiset<lwg::issue, order_by_first_tag> const  all_issues{ issues.begin(), issues.end()} ;
-   std::multiset<lwg::issue, order_by_status>    const  issues_by_status{ issues.begin(), issues.end() };
+struct issue_counts {
+   // The number of issues sharing each first section tag, among all issues and among the active issues, and
+   // the number sharing each status priority, counted once for the "View other issues" links of each issue.
+   explicit issue_counts(std::vector<lwg::issue> const & issues) {
+      for (auto const & iss : issues) {
+         assert(!iss.tags.empty());
+         ++by_first_tag[iss.tags.front()];
+         if (lwg::is_active(iss.stat)) {
+            ++active_by_first_tag[iss.tags.front()];
+         }
+         ++by_status[lwg::get_status_priority(iss.stat)];
+      }
+   }
 
-   std::multiset<lwg::issue, order_by_first_tag> active_issues;
-   for (auto const & elem : issues ) {
-      if (lwg::is_active(elem.stat)) {
-         active_issues.insert(elem);
+   auto all_in_section(lwg::issue const & iss) const -> std::size_t { return count(by_first_tag, iss.tags.front()); }
+   auto active_in_section(lwg::issue const & iss) const -> std::size_t { return count(active_by_first_tag, iss.tags.front()); }
+   auto with_status(lwg::issue const & iss) const -> std::size_t { return count(by_status, lwg::get_status_priority(iss.stat)); }
+
+private:
+   template <typename Map>
+   static auto count(Map const & counts, typename Map::key_type const & key) -> std::size_t {
+      auto const i = counts.find(key);
+      return i == counts.end() ? 0 : i->second;
+   }
+
+   std::map<lwg::section_tag, std::size_t>  by_first_tag;
+   std::map<lwg::section_tag, std::size_t>  active_by_first_tag;
+   std::map<std::ptrdiff_t, std::size_t>    by_status;
+};
+
+void print_referrers(std::ostream & out, lwg::issue const & iss, std::vector<lwg::issue> const & issues, lwg::reference_graph const & references) {
+   // List the issues whose text refers to 'iss', other than those already listed as its duplicates.
+   // 'issues' must be sorted by issue number.
+   char const * sep{""};
+   for (auto num : references.referenced_by(iss.num)) {
+      auto const n = std::lower_bound(issues.begin(), issues.end(), num, lwg::order_by_issue_number{});
+      if (n == issues.end()  or  n->num != num) {
+         continue;
       }
+      auto const anchor = make_html_anchor(*n);
+      if (iss.duplicates.count(anchor) == 0) {
+         out << (*sep ? sep : "<p><b>Referenced by:</b> ") << anchor;
+         sep = ", ";
+      }
+   }
+   if (*sep) {
+      out << "</p>\n";
    }
+}
 
-   for (auto const & iss : issues) {
-      if (pred(iss)) {
-         out << "<hr>\n";
+void print_issue(std::ostream & out, lwg::issue const & iss, std::vector<lwg::issue> const & issues, lwg::section_index const & section_db, lwg::reference_graph const & references, issue_counts const & counts) {
+   out << "<hr>\n";
 
-         // Number and title
-         out << "<h3><a name=\"" << iss.num << "\"></a>" << iss.num << ". " << iss.title << "</h3>\n";
+   // Number and title
+   out << "<h3><a name=\"" << iss.num << "\"></a>" << iss.num << ". " << iss.title << "</h3>\n";
 
-         // Section, Status, Submitter, Date
-         out << "<p><b>Section:</b> ";
-         out << section_db[iss.tags[0]] << " " << iss.tags[0];
-         for (unsigned k = 1; k < iss.tags.size(); ++k) {
-            out << ", " << section_db[iss.tags[k]] << " " << iss.tags[k];
-         }
+   // Section, Status, Submitter, Date
+   out << "<p><b>Section:</b> ";
+   out << section_db.label(iss.tags[0]) << " " << iss.tags[0];
+   for (unsigned k = 1; k < iss.tags.size(); ++k) {
+      out << ", " << section_db.label(iss.tags[k]) << " " << iss.tags[k];
+   }
 
-         out << " <b>Status:</b> <a href=\"lwg-active.html#" << lwg::remove_qualifier(iss.stat) << "\">" << iss.stat << "</a>\n";
-         out << " <b>Submitter:</b> " << iss.submitter
-             << " <b>Opened:</b> ";
-         print_date(out, iss.date);
-         out << " <b>Last modified:</b> ";
-         print_date(out, iss.mod_date);
-         out << "</p>\n";
-
-         // view active issues in []
-         if (active_issues.count(iss) > 1) {
-            out << "<p><b>View other</b> <a href=\"lwg-index-open.html#" << remove_square_brackets(iss.tags[0]) << "\">active issues</a> in " << iss.tags[0] << ".</p>\n";
-         }
+   out << " <b>Status:</b> <a href=\"lwg-active.html#" << lwg::remove_qualifier(iss.stat) << "\">" << iss.stat << "</a>\n";
+   out << " <b>Submitter:</b> " << iss.submitter
+       << " <b>Opened:</b> ";
+   print_date(out, iss.date);
+   out << " <b>Last modified:</b> ";
+   print_date(out, iss.mod_date);
+   out << "</p>\n";
+
+   // view active issues in []
+   if (counts.active_in_section(iss) > 1) {
+      out << "<p><b>View other</b> <a href=\"lwg-index-open.html#" << remove_square_brackets(iss.tags[0]) << "\">active issues</a> in " << iss.tags[0] << ".</p>\n";
+   }
 
-         // view all issues in []
-         if (all_issues.count(iss) > 1) {
-            out << "<p><b>View all other</b> <a href=\"lwg-index.html#" << remove_square_brackets(iss.tags[0]) << "\">issues</a> in " << iss.tags[0] << ".</p>\n";
-         }
-         // view all issues with same status
-         if (issues_by_status.count(iss) > 1) {
-            out << "<p><b>View all issues with</b> <a href=\"lwg-status.html#" << iss.stat << "\">" << iss.stat << "</a> status.</p>\n";
-         }
+   // view all issues in []
+   if (counts.all_in_section(iss) > 1) {
+      out << "<p><b>View all other</b> <a href=\"lwg-index.html#" << remove_square_brackets(iss.tags[0]) << "\">issues</a> in " << iss.tags[0] << ".</p>\n";
+   }
+   // view all issues with same status
+   if (counts.with_status(iss) > 1) {
+      out << "<p><b>View all issues with</b> <a href=\"lwg-status.html#" << iss.stat << "\">" << iss.stat << "</a> status.</p>\n";
+   }
 
-         // duplicates
-         if (!iss.duplicates.empty()) {
-            out << "<p><b>Duplicate of:</b> ";
-            print_list(out, iss.duplicates, ", ");
-            out << "</p>\n";
-         }
+   // duplicates
+   if (!iss.duplicates.empty()) {
+      out << "<p><b>Duplicate of:</b> ";
+      print_list(out, iss.duplicates, ", ");
+      out << "</p>\n";
+   }
+
+   // issues that refer to this one
+   print_referrers(out, iss, issues, references);
 
-         // text
-         out << iss.text << "\n\n";
+   // text
+   out << iss.text << "\n\n";
+}
+
+template <typename Pred>
+void print_issues(std::ostream & out, std::vector<lwg::issue> const & issues, lwg::section_index const & section_db, lwg::reference_graph const & references, Pred pred) {
+   issue_counts const counts{issues};
+   for (auto const & iss : issues) {
+      if (pred(iss)) {
+         print_issue(out, iss, issues, section_db, references, counts);
       }
    }
 }
 
 template <typename Pred>
-void print_resolutions(std::ostream & out, std::vector<lwg::issue> const & issues, lwg::section_map & section_db, Pred predicate) {
-   // This construction calls out for filter-iterators
-//   std::multiset<lwg::issue, order_by_first_tag> pending_issues;
-   std::vector<lwg::issue> pending_issues;
+void print_resolutions(std::ostream & out, std::vector<lwg::issue> const & issues, lwg::section_index const & section_db, Pred predicate) {
+   // Sort by the packed key of each issue's first section, looked up once per issue rather than twice per comparison
+   using keyed_issue = std::pair<lwg::section_key, lwg::issue const *>;
+   std::vector<keyed_issue> pending_issues;
    for (auto const & elem : issues ) {
       if (predicate(elem)) {
-         pending_issues.emplace_back(elem);
+         assert(!elem.tags.empty());
+         pending_issues.emplace_back(lwg::section_key{section_db[elem.tags.front()]}, &elem);
       }
    }
 
-   sort(begin(pending_issues), end(pending_issues), order_by_section{section_db});
+   sort(begin(pending_issues), end(pending_issues), [](keyed_issue const & x, keyed_issue const & y) { return x.first < y.first; });
 
-   for (auto const & iss : pending_issues) {
+   for (auto const & keyed : pending_issues) {
+      lwg::issue const & iss = *keyed.second;
       if (predicate(iss)) {
          out << "<hr>\n"
 
              // Number and title
-             << "<h3><a name=\"" << iss.num << "\"></a>" << iss.num << ". " << iss.title << "</h3>\n"
+             << "<h3><a name=\"" << iss.num << "\"></a>" << iss.num << ". " << iss.title << "</h3>\n";
 
-             // text
-             << iss.resolution << "\n\n";
+         // text, read in place from the formatted issue
+         out.write(iss.text.data() + iss.resolution.first, static_cast<std::streamsize>(iss.resolution.size()));
+         out << "\n\n";
       }
    }
 }
 
-void print_paper_heading(std::ostream& out, std::string const & paper, lwg::mailing_info const & lwg_issues_xml) {
+void print_paper_heading(std::ostream& out, std::string const & paper, lwg::mailing_info const & lwg_issues_xml, std::tm const & build_time, std::string const & build_timestamp) {
    out <<
 R"(<table>
 <tr>
@@ -349,7 +468,7 @@ R"(<table>
 </tr>
 <tr>
   <td align="left">Date:</td>
-  <td align="left">)" << format_time("%Y-%m-%d", utc_timestamp()) << R"(</td>
+  <td align="left">)" << format_time("%Y-%m-%d", build_time) << R"(</td>
 </tr>
 <tr>
   <td align="left">Project:</td>
@@ -376,11 +495,44 @@ R"(<table>
    out << "<p>" << build_timestamp << "</p>";
 }
 
+
+// The issues that each of the issues lists prints in full, shared with 'prints_issue_text'
+auto in_active_list(lwg::issue const & i) -> bool     { return lwg::is_active(i.stat); }
+auto in_defects_list(lwg::issue const & i) -> bool    { return lwg::is_defect(i.stat); }
+auto in_closed_list(lwg::issue const & i) -> bool     { return lwg::is_closed(i.stat); }
+auto in_tentative_list(lwg::issue const & i) -> bool  { return lwg::is_tentative(i.stat); }
+auto in_unresolved_list(lwg::issue const & i) -> bool { return lwg::is_not_resolved(i.stat); }
+auto in_immediate_list(lwg::issue const & i) -> bool  { return "Immediate" == i.stat; }
+auto in_editors_list(lwg::issue const & i) -> bool    { return "Pending WP" == i.stat; }
+
 } // close unnamed namespace
 
 namespace lwg
 {
 
+auto prints_issue_text(std::string const & document, issue const & iss) -> bool {
+   static struct {
+      char const *  filename;
+      bool       (* prints)(issue const &);
+   } const issues_lists[] = {
+      { "lwg-active.html",            in_active_list },
+      { "lwg-defects.html",           in_defects_list },
+      { "lwg-closed.html",            in_closed_list },
+      { "lwg-tentative.html",         in_tentative_list },
+      { "lwg-unresolved.html",        in_unresolved_list },
+      { "lwg-immediate.html",         in_immediate_list },
+      { "lwg-issues-for-editor.html", in_editors_list },
+   };
+
+   for (auto const & list : issues_lists) {
+      if (document == list.filename) {
+         return list.prints(iss);
+      }
+   }
+   return false;
+}
+
+
 // Functions to make the 3 standard published issues list documents
 // A precondition for calling any of these functions is that the list of issues is sorted in numerical order, by issue number.
 // While nothing disasterous will happen if this precondition is violated, the published issues list will list items
@@ -389,17 +541,16 @@ void report_generator::make_active(std::vector<issue> const & issues, std::strin
    assert(std::is_sorted(issues.begin(), issues.end(), order_by_issue_number{}));
 
    std::string filename{path + "lwg-active.html"};
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "C++ Standard Library Active Issues List");
-   print_paper_heading(out, "active", lwg_issues_xml);
+   print_paper_heading(out, "active", lwg_issues_xml, build_time, build_timestamp);
    out << lwg_issues_xml.get_intro("active") << '\n';
    out << "<h2>Revision History</h2>\n" << lwg_issues_xml.get_revisions(issues, diff_report) << '\n';
    out << "<h2><a name=\"Status\"></a>Issue Status</h2>\n" << lwg_issues_xml.get_statuses() << '\n';
    out << "<h2>Active Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_active(i.stat);} );
+   print_issues(out, issues, section_db, references, in_active_list);
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 
@@ -407,16 +558,15 @@ void report_generator::make_defect(std::vector<issue> const & issues, std::strin
    assert(std::is_sorted(issues.begin(), issues.end(), order_by_issue_number{}));
 
    std::string filename{path + "lwg-defects.html"};
-   std::ofstream out(filename.c_str());
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "C++ Standard Library Defect Report List");
-   print_paper_heading(out, "defect", lwg_issues_xml);
+   print_paper_heading(out, "defect", lwg_issues_xml, build_time, build_timestamp);
    out << lwg_issues_xml.get_intro("defect") << '\n';
    out << "<h2>Revision History</h2>\n" << lwg_issues_xml.get_revisions(issues, diff_report) << '\n';
    out << "<h2>Defect Reports</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_defect(i.stat);} );
+   print_issues(out, issues, section_db, references, in_defects_list);
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 
@@ -424,16 +574,15 @@ void report_generator::make_closed(std::vector<issue> const & issues, std::strin
    assert(std::is_sorted(issues.begin(), issues.end(), order_by_issue_number{}));
 
    std::string filename{path + "lwg-closed.html"};
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "C++ Standard Library Closed Issues List");
-   print_paper_heading(out, "closed", lwg_issues_xml);
+   print_paper_heading(out, "closed", lwg_issues_xml, build_time, build_timestamp);
    out << lwg_issues_xml.get_intro("closed") << '\n';
    out << "<h2>Revision History</h2>\n" << lwg_issues_xml.get_revisions(issues, diff_report) << '\n';
    out << "<h2>Closed Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_closed(i.stat);} );
+   print_issues(out, issues, section_db, references, in_closed_list);
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 
@@ -443,9 +592,7 @@ void report_generator::make_tentative(std::vector<issue> const & issues, std::st
    assert(std::is_sorted(issues.begin(), issues.end(), order_by_issue_number{}));
 
    std::string filename{path + "lwg-tentative.html"};
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "C++ Standard Library Tentative Issues");
 //   print_paper_heading(out, "active", lwg_issues_xml);
 //   out << lwg_issues_xml.get_intro("active") << '\n';
@@ -453,8 +600,9 @@ void report_generator::make_tentative(std::vector<issue> const & issues, std::st
 //   out << "<h2><a name=\"Status\"></a>Issue Status</h2>\n" << lwg_issues_xml.get_statuses() << '\n';
    out << "<p>" << build_timestamp << "</p>";
    out << "<h2>Tentative Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_tentative(i.stat);} );
+   print_issues(out, issues, section_db, references, in_tentative_list);
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 
@@ -463,9 +611,7 @@ void report_generator::make_unresolved(std::vector<issue> const & issues, std::s
    assert(std::is_sorted(issues.begin(), issues.end(), order_by_issue_number{}));
 
    std::string filename{path + "lwg-unresolved.html"};
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "C++ Standard Library Unresolved Issues");
 //   print_paper_heading(out, "active", lwg_issues_xml);
 //   out << lwg_issues_xml.get_intro("active") << '\n';
@@ -473,8 +619,9 @@ void report_generator::make_unresolved(std::vector<issue> const & issues, std::s
 //   out << "<h2><a name=\"Status\"></a>Issue Status</h2>\n" << lwg_issues_xml.get_statuses() << '\n';
    out << "<p>" << build_timestamp << "</p>";
    out << "<h2>Unresolved Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_not_resolved(i.stat);} );
+   print_issues(out, issues, section_db, references, in_unresolved_list);
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 void report_generator::make_immediate(std::vector<issue> const & issues, std::string const & path) {
@@ -482,9 +629,7 @@ void report_generator::make_immediate(std::vector<issue> const & issues, std::st
    assert(std::is_sorted(issues.begin(), issues.end(), order_by_issue_number{}));
 
    std::string filename{path + "lwg-immediate.html"};
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "C++ Standard Library Issues Resolved Directly In [INSERT CURRENT MEETING HERE]");
 out << R"(<h1>C++ Standard Library Issues Resolved Directly In [INSERT CURRENT MEETING HERE]</h1>
 <table>
@@ -507,8 +652,9 @@ out << R"(<h1>C++ Standard Library Issues Resolved Directly In [INSERT CURRENT M
 </table>
 )";
    out << "<h2>Immediate Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return "Immediate" == i.stat;} );
+   print_issues(out, issues, section_db, references, in_immediate_list);
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 void report_generator::make_editors_issues(std::vector<issue> const & issues, std::string const & path) {
@@ -516,22 +662,25 @@ void report_generator::make_editors_issues(std::vector<issue> const & issues, st
    assert(std::is_sorted(issues.begin(), issues.end(), order_by_issue_number{}));
 
    std::string filename{path + "lwg-issues-for-editor.html"};
-   std::ofstream out{filename.c_str()};
-   if (!out) {
-     throw std::runtime_error{"Failed to open " + filename};
-   }
+   std::ostringstream out;
    print_file_header(out, "C++ Standard Library Issues Resolved Directly In [INSERT CURRENT MEETING HERE]");
    out << "<h1>C++ Standard Library Issues Resolved In [INSERT CURRENT MEETING HERE]</h1>\n";
-   print_resolutions(out, issues, section_db, [](issue const & i) {return "Pending WP" == i.stat;} );
+   print_resolutions(out, issues, section_db, in_editors_list);
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
-void report_generator::make_sort_by_num(std::vector<issue>& issues, std::string const & filename) {
-   sort(issues.begin(), issues.end(), order_by_issue_number{});
+void report_generator::make_toc_text(toc_snapshot const & snapshot, std::string const & filename) {
+   std::ostringstream out;
+   write_toc_snapshot(out, snapshot);
+   publish(filename, out.str());
+}
 
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+void report_generator::make_sort_by_num(issue_table const & issues, std::string const & filename) {
+   auto rows = issues.rows();
+   sort(rows.begin(), rows.end(), order_rows_by_issue_number{issues});
+
+   std::ostringstream out;
    print_file_header(out, "LWG Table of Contents");
 
    out <<
@@ -543,17 +692,17 @@ R"(<h1>C++ Standard Library Issues List (Revision )" << lwg_issues_xml.get_revis
 )";
    out << "<p>" << build_timestamp << "</p>";
 
-   print_table(out, issues.begin(), issues.end(), section_db);
+   print_table(out, issues, rows.begin(), rows.end(), section_db, issue_pages_made);
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 
-void report_generator::make_sort_by_priority(std::vector<issue>& issues, std::string const & filename) {
-   sort(issues.begin(), issues.end(), order_by_priority{section_db});
+void report_generator::make_sort_by_priority(issue_table const & issues, std::string const & filename) {
+   auto rows = issues.rows();
+   sort(rows.begin(), rows.end(), order_rows_by_priority{issues});
 
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "LWG Table of Contents");
 
    out <<
@@ -565,11 +714,11 @@ R"(<h1>C++ Standard Library Issues List (Revision )" << lwg_issues_xml.get_revis
 )";
    out << "<p>" << build_timestamp << "</p>";
 
-//   print_table(out, issues.begin(), issues.end(), section_db);
+//   print_table(out, issues, rows.begin(), rows.end(), section_db);
 
-   for (auto i = issues.cbegin(), e = issues.cend(); i != e;) {
-      int px = i->priority;
-      auto j = std::find_if(i, e, [&](issue const & iss){ return iss.priority != px; } );
+   for (auto i = rows.cbegin(), e = rows.cend(); i != e;) {
+      int px = issues.priority[*i];
+      auto j = std::find_if(i, e, [&](issue_row row){ return issues.priority[row] != px; } );
       out << "<h2><a name=\"Priority " << px << "\"</a>";
       if (px == 99) {
          out << "Not Prioritized";
@@ -578,23 +727,23 @@ R"(<h1>C++ Standard Library Issues List (Revision )" << lwg_issues_xml.get_revis
          out << "Priority " << px;
       }
       out << " (" << (j-i) << " issues)</h2>\n";
-      print_table(out, i, j, section_db);
+      print_table(out, issues, i, j, section_db, issue_pages_made);
       i = j;
    }
 
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 
-void report_generator::make_sort_by_status(std::vector<issue>& issues, std::string const & filename) {
-   sort(issues.begin(), issues.end(), order_by_issue_number{});
-   stable_sort(issues.begin(), issues.end(), [](issue const & x, issue const & y) { return x.mod_date > y.mod_date; } );
-   stable_sort(issues.begin(), issues.end(), order_by_section{section_db});
-   stable_sort(issues.begin(), issues.end(), order_by_status{});
+void report_generator::make_sort_by_status(issue_table const & issues, std::string const & filename) {
+   auto rows = issues.rows();
+   sort(rows.begin(), rows.end(), order_rows_by_issue_number{issues});
+   stable_sort(rows.begin(), rows.end(), order_rows_by_mod_date_descending{issues});
+   stable_sort(rows.begin(), rows.end(), order_rows_by_section{issues});
+   stable_sort(rows.begin(), rows.end(), order_rows_by_status{issues});
 
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "LWG Index by Status and Section");
 
    out <<
@@ -609,27 +758,27 @@ This document is the Index by Status and Section for the <a href="lwg-active.htm
 )";
    out << "<p>" << build_timestamp << "</p>";
 
-   for (auto i = issues.cbegin(), e = issues.cend(); i != e;) {
-      auto const & current_status = i->stat;
-      auto j = std::find_if(i, e, [&](issue const & iss){ return iss.stat != current_status; } );
-      out << "<h2><a name=\"" << current_status << "\"</a>" << current_status << " (" << (j-i) << " issues)</h2>\n";
-      print_table(out, i, j, section_db);
+   for (auto i = rows.cbegin(), e = rows.cend(); i != e;) {
+      auto const current_status = issues.status[*i];
+      auto j = std::find_if(i, e, [&](issue_row row){ return issues.status[row] != current_status; } );
+      out << "<h2><a name=\"" << issues.statuses[current_status] << "\"</a>" << issues.statuses[current_status] << " (" << (j-i) << " issues)</h2>\n";
+      print_table(out, issues, i, j, section_db, issue_pages_made);
       i = j;
    }
 
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 
-void report_generator::make_sort_by_status_mod_date(std::vector<issue> & issues, std::string const & filename) {
-   sort(issues.begin(), issues.end(), order_by_issue_number{});
-   stable_sort(issues.begin(), issues.end(), order_by_section{section_db});
-   stable_sort(issues.begin(), issues.end(), [](issue const & x, issue const & y) { return x.mod_date > y.mod_date; } );
-   stable_sort(issues.begin(), issues.end(), order_by_status{});
+void report_generator::make_sort_by_status_mod_date(issue_table const & issues, std::string const & filename) {
+   auto rows = issues.rows();
+   sort(rows.begin(), rows.end(), order_rows_by_issue_number{issues});
+   stable_sort(rows.begin(), rows.end(), order_rows_by_section{issues});
+   stable_sort(rows.begin(), rows.end(), order_rows_by_mod_date_descending{issues});
+   stable_sort(rows.begin(), rows.end(), order_rows_by_status{issues});
 
-   std::ofstream out{filename.c_str()};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "LWG Index by Status and Date");
 
    out <<
@@ -643,43 +792,43 @@ This document is the Index by Status and Date for the <a href="lwg-active.html">
 )";
    out << "<p>" << build_timestamp << "</p>";
 
-   for (auto i = issues.cbegin(), e = issues.cend(); i != e;) {
-      std::string const & current_status = i->stat;
-      auto j = find_if(i, e, [&](issue const & iss){ return iss.stat != current_status; } );
-      out << "<h2><a name=\"" << current_status << "\"</a>" << current_status << " (" << (j-i) << " issues)</h2>\n";
-      print_table(out, i, j, section_db);
+   for (auto i = rows.cbegin(), e = rows.cend(); i != e;) {
+      auto const current_status = issues.status[*i];
+      auto j = find_if(i, e, [&](issue_row row){ return issues.status[row] != current_status; } );
+      out << "<h2><a name=\"" << issues.statuses[current_status] << "\"</a>" << issues.statuses[current_status] << " (" << (j-i) << " issues)</h2>\n";
+      print_table(out, issues, i, j, section_db, issue_pages_made);
       i = j;
    }
 
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
 
-void report_generator::make_sort_by_section(std::vector<issue>& issues, std::string const & filename, bool active_only) {
-   sort(issues.begin(), issues.end(), order_by_issue_number{});
-   stable_sort(issues.begin(), issues.end(), [](issue const & x, issue const & y) { return x.mod_date > y.mod_date; } );
-   stable_sort(issues.begin(), issues.end(), order_by_status{});
-   auto b = issues.begin();
-   auto e = issues.end();
+void report_generator::make_sort_by_section(issue_table const & issues, std::string const & filename, bool active_only) {
+   auto rows = issues.rows();
+   sort(rows.begin(), rows.end(), order_rows_by_issue_number{issues});
+   stable_sort(rows.begin(), rows.end(), order_rows_by_mod_date_descending{issues});
+   stable_sort(rows.begin(), rows.end(), order_rows_by_status{issues});
+   auto b = rows.begin();
+   auto e = rows.end();
    if(active_only) {
-      auto bReady = find_if(b, e, [](issue const & iss){ return "Ready" == iss.stat; });
+      auto bReady = find_if(b, e, [&](issue_row row){ return "Ready" == issues.status_of(row); });
       if(bReady != e) {
          b = bReady;
       }
-      b = find_if(b, e, [](issue const & iss){ return "Ready" != iss.stat; });
-      e = find_if(b, e, [](issue const & iss){ return !is_active(iss.stat); });
+      b = find_if(b, e, [&](issue_row row){ return "Ready" != issues.status_of(row); });
+      e = find_if(b, e, [&](issue_row row){ return !is_active(issues.status_of(row)); });
    }
-   stable_sort(b, e, order_by_section{section_db});
-   std::set<issue, order_by_major_section> mjr_section_open{order_by_major_section{section_db}};
-   for (auto const & elem : issues ) {
-      if (is_active_not_ready(elem.stat)) {
-         mjr_section_open.insert(elem);
+   stable_sort(b, e, order_rows_by_section{issues});
+   std::set<issue_row, order_by_major_section> mjr_section_open{order_by_major_section{issues}};
+   for (auto row : rows) {
+      if (is_active_not_ready(issues.status_of(row))) {
+         mjr_section_open.insert(row);
       }
    }
 
-   std::ofstream out(filename.c_str());
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename};
+   std::ostringstream out;
    print_file_header(out, "LWG Index by Section");
 
    out << "<h1>C++ Standard Library Issues List (Revision " << lwg_issues_xml.get_revision() << ")</h1>\n";
@@ -705,15 +854,14 @@ void report_generator::make_sort_by_section(std::vector<issue>& issues, std::str
 
    // Would prefer to use const_iterators from here, but oh well....
    for (auto i = b; i != e;) {
-assert(!i->tags.empty());
-      int current_num = section_db[i->tags[0]].num[0];
+      auto const & current_key = issues.section_key_of(*i);
       auto j = i;
       for (; j != e; ++j) {
-         if (section_db[j->tags[0]].num[0] != current_num) {
+         if (!same_major_section(issues.section_key_of(*j), current_key)) {
              break;
          }
       }
-      std::string const msn{major_section(section_db[i->tags[0]])};
+      std::string const msn{major_section(issues.section_of(*i))};
       out << "<h2><a name=\"Section " << msn << "\"></a>" << "Section " << msn << " (" << (j-i) << " issues)</h2>\n";
       if (active_only) {
          out << "<p><a href=\"lwg-index.html#Section " << msn << "\">(view all issues)</a></p>\n";
@@ -722,12 +870,111 @@ assert(!i->tags.empty());
          out << "<p><a href=\"lwg-index-open.html#Section " << msn << "\">(view only non-Ready open issues)</a></p>\n";
       }
 
-      print_table(out, i, j, section_db);
+      print_table(out, issues, i, j, section_db, issue_pages_made);
       i = j;
    }
 
    print_file_trailer(out);
+   publish(filename, out.str());
 }
 
-} // close namespace lwg
+report_generator::report_generator(mailing_info const & info, section_index const & sections, reference_graph const & graph, std::time_t build)
+   : lwg_issues_xml(info)
+   , section_db(sections)
+   , references(graph)
+   , build_time(*std::gmtime(&build))
+   , build_timestamp{format_time("<p>Revised %Y-%m-%d at %H:%m:%S UTC</p>\n", build_time)}
+   , made_documents{}
+   , rewritten_documents{}
+   , issue_pages_made{false}
+{
+}
+
+void report_generator::make_issue_pages(std::vector<issue> const & issues, std::string const & path) {
+   assert(std::is_sorted(issues.begin(), issues.end(), order_by_issue_number{}));
+
+   make_directory(path + "issues");
+   make_directory(path + "sections");
 
+   // Each section page lists the issues whose first section it is, in issue number order
+   std::map<section_tag, std::vector<issue const *>> by_section;
+   for (auto const & iss : issues) {
+      assert(!iss.tags.empty());
+      by_section[iss.tags.front()].push_back(&iss);
+   }
+   std::vector<decltype(by_section)::const_iterator> sections;
+   for (auto i = by_section.cbegin(); i != by_section.cend(); ++i) {
+      sections.push_back(i);
+   }
+
+   issue_counts const counts{issues};
+   auto print_navigation = [&](std::ostream & out, issue const & iss) {
+      out << "<p><a href=\"lwg-toc.html\">Table of Contents</a> | <a href=\"lwg-index.html\">Index by Section</a> | "
+             "<a href=\"lwg-status.html\">Index by Status</a> | <a href=\"" << section_page_filename(iss.tags.front()) << "\">"
+             "Issues in " << iss.tags.front() << "</a></p>\n";
+   };
+
+   // Pages are numbered issues first, then sections.  Every page is formatted and written independently,
+   // so the pages are shared among threads, and recorded in order once all are written.
+   std::vector<std::string> filenames;
+   filenames.reserve(issues.size() + sections.size());
+   for (auto const & iss : issues) {
+      filenames.push_back(path + issue_page_filename(iss.num));
+   }
+   for (auto const & section : sections) {
+      filenames.push_back(path + section_page_filename(section->first));
+   }
+   std::vector<char> rewritten(filenames.size(), false);
+
+   parallel_for(filenames.size(), [&](std::size_t page) {
+      std::ostringstream out;
+      if (page < issues.size()) {
+         issue const & iss = issues[page];
+         print_file_header(out, "LWG Issue " + std::to_string(iss.num), "../");
+         print_navigation(out, iss);
+         print_issue(out, iss, issues, section_db, references, counts);
+      }
+      else {
+         auto const & section = *sections[page - issues.size()];
+         print_file_header(out, "LWG Issues in " + section.first, "../");
+         out << "<h1>Issues in " << section_db.label(section.first) << " " << section.first << "</h1>\n";
+         print_navigation(out, *section.second.front());
+         for (auto iss : section.second) {
+            print_issue(out, *iss, issues, section_db, references, counts);
+         }
+      }
+      print_file_trailer(out);
+      rewritten[page] = write_if_changed(filenames[page], out.str());
+   });
+
+   for (std::size_t page{0}; page != filenames.size(); ++page) {
+      made_documents.push_back(filenames[page]);
+      if (rewritten[page]) {
+         rewritten_documents.push_back(filenames[page]);
+      }
+   }
+   issue_pages_made = true;
+}
+
+
+void report_generator::publish(std::string const & filename, std::string const & contents) {
+   made_documents.push_back(filename);
+   if (write_if_changed(filename, contents)) {
+      rewritten_documents.push_back(filename);
+   }
+}
+
+void report_generator::compress_documents(compression_formats formats) const {
+   // An unchanged document keeps the siblings compressed from it before, unless one is missing or was
+   // compressed from another version of the document, such as one rewritten by a run without compression
+   std::set<std::string> const rewritten{rewritten_documents.begin(), rewritten_documents.end()};
+   std::vector<std::string> stale;
+   for (auto const & filename : made_documents) {
+      if (rewritten.count(filename)  or  !siblings_are_current(filename, formats)) {
+         stale.push_back(filename);
+      }
+   }
+   write_compressed_siblings(stale, formats);
+}
+
+} // close namespace lwg
@@ -1,10 +1,16 @@
 #ifndef INCLUDE_LWG_REPORT_GENERATOR_H
 #define INCLUDE_LWG_REPORT_GENERATOR_H
 
+#include <ctime>
 #include <string>
 #include <vector>
 
+#include "compressed_files.h"
+#include "issue_table.h"
 #include "issues.h"  // cannot forward declare the 'section_map' alias, nor the 'LwgIssuesXml' alias
+#include "reference_graph.h"
+#include "sections.h"
+#include "toc_snapshot.h"
 
 namespace lwg
 {
@@ -12,13 +18,18 @@ struct issue;
 struct mailing_info;
 
 
+auto prints_issue_text(std::string const & document, issue const & iss) -> bool;
+   // Return 'true' if the document named 'document', such as "lwg-active.html", prints the formatted text
+   // of 'iss'.  The index documents, and the issues lists for the issues they omit, refer to an issue by
+   // its number, title and status alone, which do not need formatting.
+
+
 struct report_generator {
 
-   report_generator(mailing_info const & info, section_map & sections)
-      : lwg_issues_xml(info)
-      , section_db(sections)
-   {
-   }
+   report_generator(mailing_info const & info, section_index const & sections, reference_graph const & graph, std::time_t build = std::time(nullptr));
+      // Every document is stamped with the UTC time 'build', which defaults to the time the generator is made.
+      // A document that would be written with exactly the contents it already holds is left untouched.
+      // Each issue links back to the issues that 'graph' records as referring to it.
 
    // Functions to make the 3 standard published issues list documents
    // A precondition for calling any of these functions is that the list of issues is sorted in numerical order, by issue number.
@@ -42,21 +53,55 @@ struct report_generator {
       // publish a document listing all non-tentative, non-ready issues that must be reviewed during a meeting.
 
 
-   void make_sort_by_num(std::vector<issue>& issues, std::string const & filename);
+   // Index documents, each listing every issue in 'issues' in its own order.  The issues are sorted
+   // through a permutation of the rows of the table, so neither the table nor the issues are reordered.
+   void make_sort_by_num(issue_table const & issues, std::string const & filename);
 
-   void make_sort_by_priority(std::vector<issue>& issues, std::string const & filename);
+   void make_sort_by_priority(issue_table const & issues, std::string const & filename);
 
-   void make_sort_by_status(std::vector<issue>& issues, std::string const & filename);
+   void make_sort_by_status(issue_table const & issues, std::string const & filename);
 
-   void make_sort_by_status_mod_date(std::vector<issue> & issues, std::string const & filename);
+   void make_sort_by_status_mod_date(issue_table const & issues, std::string const & filename);
 
-   void make_sort_by_section(std::vector<issue>& issues, std::string const & filename, bool active_only = false);
+   void make_sort_by_section(issue_table const & issues, std::string const & filename, bool active_only = false);
 
    void make_editors_issues(std::vector<issue> const & issues, std::string const & path);
 
+   void make_toc_text(toc_snapshot const & snapshot, std::string const & filename);
+      // publish 'snapshot' in the line-oriented format of 'write_toc_snapshot', for the next revision to diff against.
+
+
+   // Lightweight pages, for readers who want one issue, or one section, rather than a whole list
+   void make_issue_pages(std::vector<issue> const & issues, std::string const & path);
+      // publish a page for each issue, 'issues/NUM.html', and a page for each section, 'sections/TAG.html',
+      // listing every issue whose first section is TAG, both in the format of the issues lists.  The pages are
+      // formatted and written concurrently.  Index documents made afterwards link each issue number to its
+      // own page, rather than to its place in the issues lists.
+
+
+   // Output stage, run once every document has been made
+   auto documents() const noexcept -> std::vector<std::string> const & { return made_documents; }
+      // The file name of every document made so far, in the order made.
+
+   auto rewritten() const noexcept -> std::vector<std::string> const & { return rewritten_documents; }
+      // The file name of every document made so far whose contents changed, and so was written.
+
+   void compress_documents(compression_formats formats) const;
+      // Write compressed siblings, such as 'lwg-active.html.gz', of every document rewritten so far, and of
+      // any unchanged document whose siblings are missing or stale, compressing the documents concurrently.
+
 private:
-   mailing_info const & lwg_issues_xml;
-   section_map &        section_db;
+   void publish(std::string const & filename, std::string const & contents);
+      // Write the finished document 'contents' to 'filename', unless the file already holds it.
+
+   mailing_info const &      lwg_issues_xml;
+   section_index const &     section_db;
+   reference_graph const &   references;
+   std::tm                   build_time;
+   std::string               build_timestamp;
+   std::vector<std::string>  made_documents;
+   std::vector<std::string>  rewritten_documents;
+   bool                      issue_pages_made;
 };
 
 } // close namespace lwg
@@ -0,0 +1,271 @@
+#include "revision_diff.h"
+
+#include "issues.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>  // cref
+#include <ostream>
+#include <string>
+#include <tuple>
+
+namespace {
+
+struct list_issues {
+   std::vector<int> const & issues;
+};
+
+auto operator<<( std::ostream & out, list_issues const & x) -> std::ostream & {
+   auto list_separator = "";
+   for (auto number : x.issues ) {
+      out << list_separator << "<iref ref=\"" << number << "\"/>";
+      list_separator = ", ";
+   }
+   return out;
+}
+
+struct list_numbers {
+   // Removed issues cannot be the target of an <iref>, so are listed by number only.
+   std::vector<int> const & issues;
+};
+
+auto operator<<( std::ostream & out, list_numbers const & x) -> std::ostream & {
+   auto list_separator = "";
+   for (auto number : x.issues ) {
+      out << list_separator << number;
+      list_separator = ", ";
+   }
+   return out;
+}
+
+auto priority_label(int priority) -> std::string {
+   return (priority == 99) ? "Not Prioritized" : "Priority " + std::to_string(priority);
+}
+
+void count_issue(lwg::toc_entry const & entry, unsigned & n_open, unsigned & n_closed) {
+   if (lwg::is_active(entry.stat)) {
+      ++n_open;
+   }
+   else {
+      ++n_closed;
+   }
+}
+
+auto has_details(lwg::toc_entry const & entry) noexcept -> bool {
+   // Every issue file names at least one section, so only an entry recovered from HTML has none
+   return !entry.tags.empty();
+}
+
+
+// Changes are reported in groups, such as all the issues moved from Open to Ready.  Each change is
+// given a pair of sort keys and a label, and a group is a run of changes with the same keys and label
+// once sorted.  This keeps the report in 'get_status_priority' order without any map of strings.
+struct grouped_change {
+   std::ptrdiff_t           major;   // primary sort key for the group
+   std::ptrdiff_t           minor;   // secondary sort key for the group
+   std::string              label;   // distinguishes groups with the same keys, e.g., unknown statuses
+   lwg::toc_change const *  change;
+};
+
+auto same_group(grouped_change const & x, grouped_change const & y) -> bool {
+   return x.major == y.major  and  x.minor == y.minor  and  x.label == y.label;
+}
+
+auto issue_number(lwg::toc_change const & change) noexcept -> int {
+   return change.new_entry ? change.new_entry->num : change.old_entry->num;
+}
+
+template <typename PrintGroup>
+void print_groups(std::vector<grouped_change> items, PrintGroup print_group) {
+   // Call 'print_group(first, numbers)' for each group in 'items', in sorted order, where 'first'
+   // is the first change in the group and 'numbers' lists every issue in the group.
+   std::sort(items.begin(), items.end(), [](grouped_change const & x, grouped_change const & y) {
+      return std::make_tuple(x.major, x.minor, std::cref(x.label), issue_number(*x.change))
+           < std::make_tuple(y.major, y.minor, std::cref(y.label), issue_number(*y.change));
+   });
+
+   std::vector<int> numbers;
+   for (auto i = items.cbegin(), e = items.cend(); i != e;) {
+      auto j = std::find_if(i, e, [&](grouped_change const & item) { return !same_group(*i, item); });
+      numbers.clear();
+      std::transform(i, j, back_inserter(numbers), [](grouped_change const & item) { return issue_number(*item.change); });
+      print_group(*i->change, numbers);
+      i = j;
+   }
+}
+
+void print_up_or_down(std::ostream & out, unsigned now, unsigned before) {
+   if (now >= before) {
+      out << "up by " << now - before;
+   }
+   else {
+      out << "down by " << before - now;
+   }
+}
+
+} // close unnamed namespace
+
+
+auto lwg::diff_toc_snapshots(toc_snapshot const & old_issues, toc_snapshot const & new_issues) -> snapshot_diff {
+   snapshot_diff result;
+
+   auto i = old_issues.cbegin(), ie = old_issues.cend();
+   auto j = new_issues.cbegin(), je = new_issues.cend();
+   while (i != ie  or  j != je) {
+      if (j == je  or  (i != ie  and  i->num < j->num)) {
+         count_issue(*i, result.old_open, result.old_closed);
+         result.changes.push_back(toc_change{toc_change::removed, &*i, nullptr});
+         ++i;
+      }
+      else if (i == ie  or  j->num < i->num) {
+         count_issue(*j, result.new_open, result.new_closed);
+         result.changes.push_back(toc_change{toc_change::added, nullptr, &*j});
+         ++j;
+      }
+      else {
+         count_issue(*i, result.old_open, result.old_closed);
+         count_issue(*j, result.new_open, result.new_closed);
+
+         unsigned what{0};
+         if (i->stat != j->stat) {
+            what |= toc_change::status;
+         }
+         if (has_details(*i)  and  has_details(*j)) {
+            if (i->priority != j->priority) {
+               what |= toc_change::priority;
+            }
+            if (i->title != j->title) {
+               what |= toc_change::title;
+            }
+            if (i->tags != j->tags) {
+               what |= toc_change::sections;
+            }
+         }
+         if (what != 0) {
+            result.changes.push_back(toc_change{what, &*i, &*j});
+         }
+         ++i;
+         ++j;
+      }
+   }
+
+   return result;
+}
+
+
+void lwg::print_revision_diff(std::ostream & out, snapshot_diff const & diff) {
+   std::vector<grouped_change> added, removed, status, priority, title, sections;
+   for (auto const & change : diff.changes) {
+      if (change.what & toc_change::added) {
+         added.push_back(grouped_change{get_status_priority(change.new_entry->stat), 0, change.new_entry->stat, &change});
+      }
+      if (change.what & toc_change::removed) {
+         removed.push_back(grouped_change{0, 0, std::string{}, &change});
+      }
+      if (change.what & toc_change::status) {
+         status.push_back(grouped_change{get_status_priority(change.new_entry->stat),
+                                         get_status_priority(change.old_entry->stat),
+                                         change.new_entry->stat + '\t' + change.old_entry->stat,
+                                         &change});
+      }
+      if (change.what & toc_change::priority) {
+         priority.push_back(grouped_change{change.new_entry->priority, change.old_entry->priority, std::string{}, &change});
+      }
+      if (change.what & toc_change::title) {
+         title.push_back(grouped_change{0, 0, std::string{}, &change});
+      }
+      if (change.what & toc_change::sections) {
+         sections.push_back(grouped_change{0, 0, std::string{}, &change});
+      }
+   }
+
+   out << "<ul>\n"
+          "<li><b>Summary:</b><ul>\n";
+
+   out << "<li>" << diff.new_open << " open issues, ";
+   print_up_or_down(out, diff.new_open, diff.old_open);
+   out << ".</li>\n";
+
+   out << "<li>" << diff.new_closed << " closed issues, ";
+   print_up_or_down(out, diff.new_closed, diff.old_closed);
+   out << ".</li>\n";
+
+   out << "<li>" << diff.new_open + diff.new_closed << " issues total, ";
+   print_up_or_down(out, diff.new_open + diff.new_closed, diff.old_open + diff.old_closed);
+   out << ".</li>\n";
+
+   out << "</ul></li>\n"
+          "<li><b>Details:</b><ul>\n";
+
+   print_groups(added, [&](toc_change const & first, std::vector<int> const & numbers) {
+      if (1 == numbers.size()) {
+         out << "<li>Added the following " << first.new_entry->stat << " issue: <iref ref=\"" << numbers.front() << "\"/>.</li>\n";
+      }
+      else {
+         out << "<li>Added the following " << numbers.size() << " " << first.new_entry->stat << " issues: " << list_issues{numbers} << ".</li>\n";
+      }
+   });
+   if (added.empty()) {
+      out << "<li>No issues added.</li>\n";
+   }
+
+   print_groups(removed, [&](toc_change const &, std::vector<int> const & numbers) {
+      if (1 == numbers.size()) {
+         out << "<li>Removed the following issue: " << numbers.front() << ".</li>\n";
+      }
+      else {
+         out << "<li>Removed the following " << numbers.size() << " issues: " << list_numbers{numbers} << ".</li>\n";
+      }
+   });
+
+   print_groups(status, [&](toc_change const & first, std::vector<int> const & numbers) {
+      if (1 == numbers.size()) {
+         out << "<li>Changed the following issue to " << first.new_entry->stat
+             << " (from " << first.old_entry->stat << "): <iref ref=\"" << numbers.front() << "\"/>.</li>\n";
+      }
+      else {
+         out << "<li>Changed the following " << numbers.size() << " issues to " << first.new_entry->stat
+             << " (from " << first.old_entry->stat << "): " << list_issues{numbers} << ".</li>\n";
+      }
+   });
+   if (status.empty()) {
+      out << "<li>No issues changed.</li>\n";
+   }
+
+   print_groups(priority, [&](toc_change const & first, std::vector<int> const & numbers) {
+      if (1 == numbers.size()) {
+         out << "<li>Changed the following issue to " << priority_label(first.new_entry->priority)
+             << " (from " << priority_label(first.old_entry->priority) << "): <iref ref=\"" << numbers.front() << "\"/>.</li>\n";
+      }
+      else {
+         out << "<li>Changed the following " << numbers.size() << " issues to " << priority_label(first.new_entry->priority)
+             << " (from " << priority_label(first.old_entry->priority) << "): " << list_issues{numbers} << ".</li>\n";
+      }
+   });
+
+   print_groups(title, [&](toc_change const &, std::vector<int> const & numbers) {
+      if (1 == numbers.size()) {
+         out << "<li>Changed the title of the following issue: <iref ref=\"" << numbers.front() << "\"/>.</li>\n";
+      }
+      else {
+         out << "<li>Changed the title of the following " << numbers.size() << " issues: " << list_issues{numbers} << ".</li>\n";
+      }
+   });
+
+   print_groups(sections, [&](toc_change const &, std::vector<int> const & numbers) {
+      if (1 == numbers.size()) {
+         out << "<li>Changed the sections of the following issue: <iref ref=\"" << numbers.front() << "\"/>.</li>\n";
+      }
+      else {
+         out << "<li>Changed the sections of the following " << numbers.size() << " issues: " << list_issues{numbers} << ".</li>\n";
+      }
+   });
+
+   out << "</ul></li>\n"
+          "</ul>\n";
+}
+
+
+void lwg::print_current_revisions(std::ostream & out, toc_snapshot const & old_issues, toc_snapshot const & new_issues) {
+   print_revision_diff(out, diff_toc_snapshots(old_issues, new_issues));
+}
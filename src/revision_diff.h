@@ -0,0 +1,60 @@
+#ifndef INCLUDE_LWG_REVISION_DIFF_H
+#define INCLUDE_LWG_REVISION_DIFF_H
+
+// Compare two revisions of the issues list, as recorded by their TOC snapshots, and report
+// the differences for the revision history of the published lists.
+
+#include <iosfwd>
+#include <vector>
+
+#include "toc_snapshot.h"
+
+namespace lwg
+{
+
+struct toc_change {
+   enum : unsigned {
+      added    = 1 << 0,
+      removed  = 1 << 1,
+      status   = 1 << 2,
+      priority = 1 << 3,
+      title    = 1 << 4,
+      sections = 1 << 5
+   };
+
+   unsigned           what;       // bitwise-or of the kinds of change above
+   toc_entry const *  old_entry;  // the issue in the old revision, or null if 'added'
+   toc_entry const *  new_entry;  // the issue in the new revision, or null if 'removed'
+};
+
+struct snapshot_diff {
+   std::vector<toc_change> changes;  // one entry per added, removed or changed issue, sorted by issue number
+
+   unsigned old_open   = 0;          // number of active issues in the old revision
+   unsigned old_closed = 0;          // number of non-active issues in the old revision
+   unsigned new_open   = 0;
+   unsigned new_closed = 0;
+};
+
+auto diff_toc_snapshots(toc_snapshot const & old_issues, toc_snapshot const & new_issues) -> snapshot_diff;
+   // Merge the two snapshots, each sorted by issue number, in a single pass.  The returned
+   // 'changes' refer into both snapshots, which must outlive the result.
+   //
+   // Priority, title and sections are compared only when both entries record sections,
+   // as entries recovered from an old HTML TOC carry nothing but number and status.
+   //
+   // Every entry is counted as open or closed through 'is_active', which throws 'runtime_error'
+   // for a status unknown to 'filename_for_status'.  The status itself is not otherwise checked.
+
+void print_revision_diff(std::ostream & out, snapshot_diff const & diff);
+   // Write 'diff' as the nested HTML list used in the revision history, with issues
+   // referenced by <iref> tags still to be resolved against the current issues list.
+   // Groups are ordered by 'get_status_priority', which never throws: a status it does not
+   // know ranks after every known status.
+
+void print_current_revisions(std::ostream & out, toc_snapshot const & old_issues, toc_snapshot const & new_issues);
+   // Equivalent to 'print_revision_diff(out, diff_toc_snapshots(old_issues, new_issues))'.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_REVISION_DIFF_H
@@ -1,10 +1,23 @@
+// Usage:
+//    section_data <index >section.data             tabulate the tag / number pairs of an Annex F index
+//    section_data --index FILE <section.data       compile a complete section.data into the binary index FILE
+//
+// The compiled index, conventionally meta-data/section.idx, is generated locally and never committed.  It records
+// the size and hash of the text it was compiled from, and the tools that load the section index take the sections
+// from it only while meta-data/section.data still holds that text.
+
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iterator>
 #include <string>
 #include <vector>
 #include <utility>
 #include <stdexcept>
 #include <algorithm>
 
+#include "sections.h"
+
 struct section_num
 {
     std::string prefix;
@@ -138,8 +151,25 @@ replace_all(std::string s, const std::string& old, const std::string& nw)
     return s;
 }
 
-int main ()
+int main (int argc, char* argv[])
 {
+    if (argc == 3 && std::string(argv[1]) == "--index")
+    {
+        std::string const source(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>{});
+        std::istringstream in(source);
+        lwg::section_map section_db = lwg::read_section_db(in);
+        std::ofstream out(argv[2], std::ios::out | std::ios::binary);
+        if (!out)
+            throw std::runtime_error(std::string("unable to open ") + argv[2]);
+        lwg::write_section_index(out, section_db, source);
+        return 0;
+    }
+    if (argc != 1)
+    {
+        std::cerr << "usage: section_data [--index FILE]\n";
+        return 2;
+    }
+
     std::vector<std::pair<section_num, section_tag> > v;
     while (std::cin)
     {
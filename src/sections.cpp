@@ -1,10 +1,17 @@
 #include "sections.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <istream>
+#include <iterator>
+#include <limits>
 #include <ostream>
-
 #include <sstream>
+#include <stdexcept>
 
 #if !defined(CPP14_LIBRARY_IS_NEEDED_FOR_STD_EXCHANGE)
 // This should be part of <utility> in C++14 lib
@@ -25,6 +32,21 @@ auto exchange(TYPE & object, V_TYPE && value) -> TYPE {
 using std::exchange;
 #endif
 
+void lwg::section_digits::push_back(int n) {
+   if (size_ == capacity) {
+      throw std::runtime_error{"section number is too deep to store"};
+   }
+   digits_[size_++] = n;
+}
+
+auto lwg::operator < (section_digits const & x, section_digits const & y) noexcept -> bool {
+   return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+}
+
+auto lwg::operator == (section_digits const & x, section_digits const & y) noexcept -> bool {
+   return x.size() == y.size()  and  std::equal(x.begin(), x.end(), y.begin());
+}
+
 auto lwg::operator < (section_num const & x, section_num const & y) noexcept -> bool {
    // prefices are unique, so there should be no need for a tiebreak.
    return (x.prefix < y.prefix) ?  true
@@ -42,6 +64,64 @@ auto lwg::operator != (section_num const & x, section_num const & y) noexcept ->
    return !(x == y);
 }
 
+lwg::section_key::section_key(section_num const & sn) noexcept
+   : packed_{0}
+   , section_{&sn}
+   {
+   std::uint64_t prefix_code{0};
+   bool exact{true};
+   if (sn.prefix.empty()) {
+      prefix_code = 0;
+   }
+   else if (sn.prefix == "TR1") {
+      prefix_code = 1;
+   }
+   else if (sn.prefix == "TRDecimal") {
+      prefix_code = 2;
+   }
+   else {
+      exact = false;
+   }
+
+   std::uint64_t packed{prefix_code};
+   std::size_t level{0};
+   for (auto n : sn.num) {
+      if (level == 7  or  n < 0  or  n > 253) {
+         exact = false;
+         break;
+      }
+      packed = (packed << 8) | static_cast<std::uint64_t>(n + 1);
+      ++level;
+   }
+   packed <<= 8 * (7 - level);
+
+   packed_ = exact ? packed : packed | inexact_flag;
+}
+
+auto lwg::operator < (section_key const & x, section_key const & y) noexcept -> bool {
+   return x.exact() and y.exact()
+        ? x.packed() < y.packed()
+        : x.section() < y.section();
+}
+
+auto lwg::operator == (section_key const & x, section_key const & y) noexcept -> bool {
+   return x.exact() and y.exact()
+        ? x.packed() == y.packed()
+        : x.section() == y.section();
+}
+
+auto lwg::same_major_section(section_key const & x, section_key const & y) noexcept -> bool {
+   // The prefix and the first number are the top two bytes of an exact key
+   if (x.exact() and y.exact()) {
+      return (x.packed() >> 48) == (y.packed() >> 48);
+   }
+   auto const & xn = x.section();
+   auto const & yn = y.section();
+   return xn.prefix == yn.prefix
+      and xn.num.empty() == yn.num.empty()
+      and (xn.num.empty() or xn.num[0] == yn.num[0]);
+}
+
 auto lwg::operator >> (std::istream& is, section_num& sn) -> std::istream & {
    sn.prefix.clear();
    sn.num.clear();
@@ -136,22 +216,29 @@ auto lwg::read_section_db(std::istream & infile) -> section_map {
             line.erase(0, 4);
          }
 
-         std::istringstream temp(line);
+         // Parse the numbers in place, rather than through a string stream for every line
+         char const * next = line.c_str();
+         auto next_char = [&next]() -> char {
+            while (std::isspace(static_cast<unsigned char>(*next))) {
+               ++next;
+            }
+            return *next ? *next++ : '\0';
+         };
+
          if (!std::isdigit(line[0])) {
-            char c;
-            temp >> c;
-            num.num.push_back(100 + c - 'A');
-            temp >> c;
+            num.num.push_back(100 + next_char() - 'A');
+            next_char();
          }
 
-         while (temp) {
-            int n;
-            temp >> n;
-            if (!temp.fail()) {
-               num.num.push_back(n);
-               char dot;
-               temp >> dot;
+         while (true) {
+            char * end;
+            long const n = std::strtol(next, &end, 10);
+            if (end == next) {
+               break;
             }
+            num.num.push_back(static_cast<int>(n));
+            next = end;
+            next_char();
          }
 
          section_db[tag] = num;
@@ -160,3 +247,245 @@ auto lwg::read_section_db(std::istream & infile) -> section_map {
    return section_db;
 }
 
+
+
+namespace {
+
+// Layout of a compiled section index, in the byte order of the machine that wrote it:
+//    header            magic, byte-order mark, number of sections, total size of the tags, and the size and
+//                      hash of the 'section.data' text the index was compiled from
+//    offsets           'count + 1' offsets of each tag in the tags, the last being the size of the tags
+//    tags              every tag, in ascending order, without separators
+//    records           'count' fixed-size section numbers, in the same order as the tags
+char const section_index_magic[8] = {'L', 'W', 'G', 'S', 'E', 'C', 'T', '2'};
+std::uint32_t const section_index_byte_order = 0x01020304;
+
+char const * const section_index_prefixes[] = { "", "TR1", "TRDecimal" };
+
+struct section_index_header {
+   char           magic[8];
+   std::uint32_t  byte_order;
+   std::uint32_t  count;
+   std::uint32_t  tag_bytes;
+   std::uint32_t  source_bytes;
+   std::uint64_t  source_hash;
+};
+
+struct section_index_record {
+   std::uint8_t   prefix;   // index into 'section_index_prefixes'
+   std::uint8_t   size;     // count of numbers used in 'num'
+   std::uint8_t   unused[2];
+   std::int32_t   num[lwg::section_digits::capacity];
+};
+
+template <typename T>
+void write_raw(std::ostream & out, T const * data, std::size_t count) {
+   out.write(reinterpret_cast<char const *>(data), static_cast<std::streamsize>(sizeof(T) * count));
+}
+
+template <typename T>
+void read_raw(std::istream & in, T * data, std::size_t count) {
+   if (!in.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(sizeof(T) * count))) {
+      throw std::runtime_error{"compiled section index is truncated"};
+   }
+}
+
+auto hash_source(std::string const & source) -> std::uint64_t {
+   // Return the 64-bit FNV-1a hash of 'source', identifying the text a compiled index was made from
+   std::uint64_t hash{14695981039346656037ull};
+   for (unsigned char c : source) {
+      hash = (hash ^ c) * 1099511628211ull;
+   }
+   return hash;
+}
+
+auto read_file(std::string const & filename, std::string & contents) -> bool {
+   // Read the whole of the text file 'filename' into 'contents', returning 'false' if it cannot be read.  The
+   // file is read in text mode, as 'section_data' reads its standard input, so the hashes agree on any platform
+   std::ifstream infile{filename};
+   if (!infile.is_open()) {
+      return false;
+   }
+   std::ostringstream buffer;
+   buffer << infile.rdbuf();
+   contents = buffer.str();
+   return !infile.bad();
+}
+
+} // close unnamed namespace
+
+void lwg::write_section_index(std::ostream & stream, section_map const & section_db, std::string const & source) {
+   section_index_header header{};
+   std::memcpy(header.magic, section_index_magic, sizeof header.magic);
+   header.byte_order = section_index_byte_order;
+   header.count = static_cast<std::uint32_t>(section_db.size());
+   header.source_bytes = static_cast<std::uint32_t>(source.size());
+   header.source_hash = hash_source(source);
+
+   std::string tags;
+   std::vector<std::uint32_t> offsets;
+   std::vector<section_index_record> records;
+   offsets.reserve(section_db.size() + 1);
+   records.reserve(section_db.size());
+   for (auto const & elem : section_db) {
+      offsets.push_back(static_cast<std::uint32_t>(tags.size()));
+      tags += elem.first;
+
+      section_index_record record{};
+      auto const prefix = std::find(std::begin(section_index_prefixes), std::end(section_index_prefixes), elem.second.prefix);
+      if (prefix == std::end(section_index_prefixes)) {
+         throw std::runtime_error{"unknown section prefix " + elem.second.prefix + " for " + elem.first};
+      }
+      record.prefix = static_cast<std::uint8_t>(prefix - std::begin(section_index_prefixes));
+      record.size = static_cast<std::uint8_t>(elem.second.num.size());
+      std::copy(elem.second.num.begin(), elem.second.num.end(), record.num);
+      records.push_back(record);
+   }
+   offsets.push_back(static_cast<std::uint32_t>(tags.size()));
+   header.tag_bytes = offsets.back();
+
+   write_raw(stream, &header, 1);
+   write_raw(stream, offsets.data(), offsets.size());
+   write_raw(stream, tags.data(), tags.size());
+   write_raw(stream, records.data(), records.size());
+   if (!stream) {
+      throw std::runtime_error{"unable to write compiled section index"};
+   }
+}
+
+auto lwg::read_section_index(std::istream & stream, std::string const & source) -> section_map {
+   section_index_header header;
+   read_raw(stream, &header, 1);
+   if (0 != std::memcmp(header.magic, section_index_magic, sizeof header.magic)  or  header.byte_order != section_index_byte_order) {
+      throw std::runtime_error{"not a compiled section index for this machine"};
+   }
+   if (header.source_bytes != source.size()  or  header.source_hash != hash_source(source)) {
+      throw std::runtime_error{"compiled section index is out of date"};
+   }
+
+   std::vector<std::uint32_t> offsets(header.count + std::size_t{1});
+   read_raw(stream, offsets.data(), offsets.size());
+   std::string tags(header.tag_bytes, '\0');
+   read_raw(stream, &tags[0], tags.size());
+   std::vector<section_index_record> records(header.count);
+   read_raw(stream, records.data(), records.size());
+
+   // The tags are stored in ascending order, so each is inserted at the end of the map
+   section_map section_db;
+   for (std::size_t i = 0; i != records.size(); ++i) {
+      auto const & record = records[i];
+      if (offsets[i] > offsets[i+1]  or  offsets[i+1] > tags.size()  or  record.prefix >= 3  or  record.size > section_digits::capacity) {
+         throw std::runtime_error{"compiled section index is corrupt"};
+      }
+
+      section_num num;
+      num.prefix = section_index_prefixes[record.prefix];
+      for (std::size_t k = 0; k != record.size; ++k) {
+         num.num.push_back(record.num[k]);
+      }
+      section_db.emplace_hint(section_db.end(), tags.substr(offsets[i], offsets[i+1] - offsets[i]), std::move(num));
+   }
+   return section_db;
+}
+
+auto lwg::load_section_db(std::string const & meta_data_path) -> section_map {
+   auto const text_file = meta_data_path + "section.data";
+   std::string text;
+   if (!read_file(text_file, text)) {
+      throw std::runtime_error{"Can't open section index " + text_file};
+   }
+
+   // The compiled index is only a cache of the text: any index that cannot be read, or that was compiled
+   // from other text, is ignored rather than reported
+   std::ifstream compiled{meta_data_path + "section.idx", std::ios::in | std::ios::binary};
+   if (compiled.is_open()) {
+      try {
+         return read_section_index(compiled, text);
+      }
+      catch (std::runtime_error const &) {
+      }
+   }
+
+   std::istringstream stream{text};
+   return read_section_db(stream);
+}
+
+
+lwg::section_index::section_index(section_map const & sections)
+   : tags_{}
+   , offsets_{}
+   , nums_{}
+   , labels_{}
+   {
+   // A 'section_map' is already sorted by tag, so the tags can be copied in order
+   std::size_t total{0};
+   for (auto const & elem : sections) {
+      total += elem.first.size();
+   }
+   if (total > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error{"section index is too large"};
+   }
+
+   tags_.reserve(total);
+   offsets_.reserve(sections.size() + 1);
+   nums_.reserve(sections.size());
+   labels_.reserve(sections.size());
+   std::ostringstream label;
+   for (auto const & elem : sections) {
+      offsets_.push_back(static_cast<std::uint32_t>(tags_.size()));
+      tags_ += elem.first;
+      nums_.push_back(elem.second);
+
+      label.str(std::string{});
+      label << elem.second;
+      labels_.push_back(label.str());
+   }
+   offsets_.push_back(static_cast<std::uint32_t>(tags_.size()));
+}
+
+auto lwg::section_index::position(section_tag const & tag) const noexcept -> std::size_t {
+   // Compare as 'std::string' does, so the order matches the 'section_map' the index was built from
+   auto compare = [&](std::size_t i) -> int {
+      auto const first = offsets_[i];
+      auto const size  = offsets_[i+1] - first;
+      auto const result = std::memcmp(tags_.data() + first, tag.data(), std::min<std::size_t>(size, tag.size()));
+      return result != 0 ? result
+           : size < tag.size() ? -1
+           : size > tag.size() ?  1
+           : 0;
+   };
+
+   std::size_t low{0};
+   std::size_t high{nums_.size()};
+   while (low < high) {
+      auto const mid = low + (high - low) / 2;
+      auto const result = compare(mid);
+      if (result == 0) {
+         return mid;
+      }
+      if (result < 0) {
+         low = mid + 1;
+      }
+      else {
+         high = mid;
+      }
+   }
+   return nums_.size();
+}
+
+auto lwg::section_index::find(section_tag const & tag) const noexcept -> section_num const * {
+   auto const i = position(tag);
+   return i != nums_.size() ? &nums_[i] : nullptr;
+}
+
+auto lwg::section_index::operator[](section_tag const & tag) const noexcept -> section_num const & {
+   static section_num const unknown{};
+   auto const sn = find(tag);
+   return sn ? *sn : unknown;
+}
+
+auto lwg::section_index::label(section_tag const & tag) const noexcept -> std::string const & {
+   static std::string const unknown{};
+   auto const i = position(tag);
+   return i != labels_.size() ? labels_[i] : unknown;
+}
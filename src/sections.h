@@ -1,6 +1,8 @@
 #ifndef INCLUDE_LWG_SECTIONS_H
 #define INCLUDE_LWG_SECTIONS_H
 
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
 #include <map>
 #include <string>
@@ -15,9 +17,36 @@ using section_tag = std::string;
 using section_map = std::map<section_tag, section_num>;
 
 
+class section_digits {
+   // The sequence of numbers in a section number, such as 17.5.2.1.4.2, held inline rather than on the heap.
+   // Lettered annex numbers are stored as 100 plus the offset of the letter from 'A'.
+public:
+   static constexpr std::size_t capacity = 8;  // deeper than any section of the standard, or of a TR/TS
+
+   auto size() const noexcept -> std::size_t { return size_; }
+   auto empty() const noexcept -> bool { return size_ == 0; }
+
+   auto begin() const noexcept -> int const * { return digits_; }
+   auto end() const noexcept -> int const * { return digits_ + size_; }
+   auto operator[](std::size_t i) const noexcept -> int { return digits_[i]; }
+
+   void push_back(int n);
+      // Append 'n'.  Throws 'runtime_error' if the section is already 'capacity' numbers deep.
+
+   void clear() noexcept { size_ = 0; }
+
+private:
+   int            digits_[capacity] = {};
+   unsigned char  size_ = 0;
+};
+
+auto operator <  (section_digits const & x, section_digits const & y) noexcept -> bool;
+auto operator == (section_digits const & x, section_digits const & y) noexcept -> bool;
+   // Section numbers compare lexicographically, so 17.5 sorts before 17.5.1, which sorts before 17.6.
+
 struct section_num {
-   std::string       prefix;  // initial prefix of section tag, if it denotes a TR/TS, or empty for the primary C++ standard
-   std::vector<int>  num;     // sequence of numbers corresponding to section number in relevant doc, e.g,, 17.5.2.1.4.2
+   std::string     prefix;  // initial prefix of section tag, if it denotes a TR/TS, or empty for the primary C++ standard
+   section_digits  num;     // sequence of numbers corresponding to section number in relevant doc, e.g,, 17.5.2.1.4.2
 };
 
 auto operator <  (section_num const & x, section_num const & y) noexcept -> bool;
@@ -32,11 +61,89 @@ auto operator >> (std::istream & is, section_num & sn) -> std::istream &;
 auto operator << (std::ostream & os, section_num const & sn) -> std::ostream &;
 
 
+class section_key {
+   // A section number packed into a single word that sorts in the same order, so that sections compare as
+   // integers.  The top byte holds the prefix, and each of the next seven bytes holds one number of the
+   // section plus one, leaving zero to sort a missing number first.  A section that does not fit, being
+   // deeper than seven numbers, numbering beyond 253, or having a prefix other than 'TR1' or 'TRDecimal',
+   // is flagged as inexact, and comparisons involving it fall back on the full 'section_num'.
+public:
+   explicit section_key(section_num const & sn) noexcept;
+      // The key refers to 'sn', which must outlive it.
+
+   auto exact() const noexcept -> bool { return (packed_ & inexact_flag) == 0; }
+   auto packed() const noexcept -> std::uint64_t { return packed_; }
+   auto section() const noexcept -> section_num const & { return *section_; }
+
+private:
+   static constexpr std::uint64_t inexact_flag = std::uint64_t{1} << 63;
+
+   std::uint64_t        packed_;
+   section_num const *  section_;
+};
+
+auto operator <  (section_key const & x, section_key const & y) noexcept -> bool;
+auto operator == (section_key const & x, section_key const & y) noexcept -> bool;
+   // Keys compare as the sections they were made from, comparing the packed words alone when both are exact.
+
+auto same_major_section(section_key const & x, section_key const & y) noexcept -> bool;
+   // Return 'true' if 'x' and 'y' have the same prefix and the same first number, as with 17.5 and 17.6.2.
+
+
 auto read_section_db(std::istream & stream) -> section_map;
    // Read the current C++ standard tag -> section number index
    // from the specified 'stream', and return it as a new
    // 'section_map' object.
 
+void write_section_index(std::ostream & stream, section_map const & section_db, std::string const & source);
+   // Write 'section_db', parsed from the text 'source', to 'stream', which should be opened in binary mode, as
+   // a compiled section index: the size and hash of 'source', the tags in ascending order packed end to end,
+   // and a fixed-size record of each section number.
+
+auto read_section_index(std::istream & stream, std::string const & source) -> section_map;
+   // Read a compiled section index, as written by 'write_section_index', from the binary 'stream'.  Throws
+   // 'runtime_error' if the stream does not hold an index written in this format and byte order, or if the
+   // index was not compiled from the text 'source'.
+
+auto load_section_db(std::string const & meta_data_path) -> section_map;
+   // Read the section index 'section.data' in the directory 'meta_data_path', taking the parsed sections
+   // from the compiled 'section.idx' beside it if that was compiled from the same text, and otherwise
+   // parsing the text.  Throws 'runtime_error' if 'section.data' cannot be read.
+
+
+class section_index {
+   // A read-only copy of a 'section_map', frozen once every section is known, for fast lookup while the
+   // issues lists are written.  The tags are packed end to end in a single buffer, sorted, and searched by
+   // bisection, and each section number is held inline in a parallel array.
+public:
+   section_index() = default;
+
+   explicit section_index(section_map const & sections);
+      // Copy every tag and section number in 'sections'.
+
+   auto size() const noexcept -> std::size_t { return nums_.size(); }
+
+   auto find(section_tag const & tag) const noexcept -> section_num const *;
+      // Return the section number for 'tag', or a null pointer if 'tag' is not in the index.
+
+   auto operator[](section_tag const & tag) const noexcept -> section_num const &;
+      // Return the section number for 'tag', or an empty section number if 'tag' is not in the index.
+      // The result refers into the index, and remains valid for as long as the index does.
+
+   auto label(section_tag const & tag) const noexcept -> std::string const &;
+      // Return the section number for 'tag' formatted for display, as by 'operator<<', or an empty
+      // string if 'tag' is not in the index.  Labels are formatted once, when the index is frozen.
+
+private:
+   auto position(section_tag const & tag) const noexcept -> std::size_t;
+      // Return the position of 'tag' in the index, or 'size()' if it is not in the index.
+
+   std::string                 tags_;     // every tag, in ascending order, without separators
+   std::vector<std::uint32_t>  offsets_;  // offset of each tag in 'tags_', followed by the size of 'tags_'
+   std::vector<section_num>    nums_;     // section number of each tag
+   std::vector<std::string>    labels_;   // section number of each tag, formatted for display
+};
+
 } // close namespace lwg
 
 
@@ -1,18 +1,35 @@
-// This program resets the status attribute of a single issue 
+// This program resets the status attribute of one or more issues.
 // It relies entirely on textual search/replace and does not
 // use any other associated functionality of the list management
-// tools.
+// tools, other than validating each requested status.
+//
+// Usage:
+//    set_status ISSUE STATUS [ISSUE STATUS]...
+//    set_status --batch [FILE]
+//
+// In batch mode, each line of FILE (or standard input, if no FILE is named) holds
+// an issue number followed by its new status, e.g. "2045 Tentatively Ready".
+// Underscores in a status are read as spaces, which simplifies unix shell scripting.
+//
+// Every requested status is validated before any file is touched.  The edits are
+// then applied concurrently, each file being written to a temporary sibling that is
+// renamed over the original, so an interrupted run never leaves a half-written issue.
 
 // standard headers
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <fstream>
 //#include <functional>
 #include <iostream>
 //#include <iterator>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 // platform headers - requires a Posix compatible platform
 // The hope is to replace all of this with the filesystem TS
@@ -20,9 +37,13 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
 
 // solution specific headers
-//#include "issues.h"
+#include "issues.h"
 //#include "sections.h"
 
 
@@ -64,8 +85,153 @@ auto read_file_into_string(std::string const & filename) -> std::string {
    return std::string {first, last};
 }
 
+void write_file_atomically(std::string const & filename, std::string const & contents) {
+   // Write 'contents' to a temporary file alongside 'filename', and then rename it over
+   // 'filename', so that readers only ever observe the old or the new file contents.  The
+   // temporary file is named for this process, so concurrent runs never share one.
+
+   std::string const temp_name{filename + '.' + std::to_string(getpid()) + ".tmp"};
+   {
+      std::ofstream out_file{temp_name};
+      if (!out_file.is_open()) {
+         throw std::runtime_error{"Unable to create file " + temp_name};
+      }
+      out_file << contents;
+      out_file.close();
+      if (!out_file) {
+         std::remove(temp_name.c_str());
+         throw std::runtime_error{"Unable to write file " + temp_name};
+      }
+   }
+
+#if defined(_WIN32)
+   // 'rename' will not replace an existing file on Windows
+   bool const replaced{MoveFileExA(temp_name.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0};
+#else
+   bool const replaced{std::rename(temp_name.c_str(), filename.c_str()) == 0};
+#endif
+   if (!replaced) {
+      std::remove(temp_name.c_str());
+      throw std::runtime_error{"Unable to replace file " + filename};
+   }
+}
+
 // ============================================================================================================
 
+struct status_change {
+   int          issue_number;
+   std::string  issue_file;   // issue file name, spelled as the issue number was requested
+   std::string  new_status;
+   std::string  result;       // message reported once the change has been attempted
+   bool         succeeded;
+};
+
+auto make_status_change(std::string const & issue, std::string status) -> status_change {
+   // Validate a single request, throwing a 'runtime_error' if either the issue number
+   // or the status is not recognised.  No file is inspected at this point.
+
+   std::size_t end{0};
+   int issue_number{0};
+   try {
+      issue_number = std::stoi(issue, &end);
+   }
+   catch (std::exception const &) {
+      end = 0;
+   }
+   if (end == 0  or  end != issue.size()  or  issue_number <= 0) {
+      throw std::runtime_error{"Invalid issue number: " + issue};
+   }
+
+   std::replace(status.begin(), status.end(), '_', ' ');  // simplifies unix shell scripting
+   lwg::filename_for_status(status);                       // throws for any unknown status
+   return status_change{issue_number, "issue" + issue + ".xml", std::move(status), std::string{}, false};
+}
+
+auto read_status_changes(std::istream & in) -> std::vector<status_change> {
+   // Read one "ISSUE STATUS" request from each non-blank line of 'in'.  The status is
+   // the remainder of the line, so may contain embedded spaces.
+
+   std::vector<status_change> changes;
+   std::string line;
+   for (unsigned line_number{1}; getline(in, line); ++line_number) {
+      auto const first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos) {
+         continue;
+      }
+      auto const split = line.find_first_of(" \t", first);
+      auto const status_first = line.find_first_not_of(" \t", split);
+      if (status_first == std::string::npos) {
+         throw std::runtime_error{"Missing status on line " + std::to_string(line_number) + ": " + line};
+      }
+      auto const status_last = line.find_last_not_of(" \t\r");
+      changes.push_back(make_status_change(line.substr(first, split - first),
+                                           line.substr(status_first, status_last + 1 - status_first)));
+   }
+   return changes;
+}
+
+void set_issue_status(std::string const & filename, int issue_number, std::string const & new_status) {
+   auto issue_data = read_file_into_string(filename);
+
+   // find 'status' tag and replace it
+   auto k = issue_data.find("<issue num=\"");
+   if (k == std::string::npos) {
+      throw bad_issue_file{filename, "Unable to find issue number"};
+   }
+   k += sizeof("<issue num=\"") - 1;
+   auto l = issue_data.find('"', k);
+   if (l == std::string::npos) {
+      throw bad_issue_file{filename, "Corrupt issue number attribute"};
+   }
+   if (std::stoi(issue_data.substr(k, l-k)) != issue_number) {
+      throw bad_issue_file{filename, "Issue number does not match filename"};
+   }
+
+   k = issue_data.find("status=\"");
+   if (k == std::string::npos) {
+      throw bad_issue_file{filename, "Unable to find issue status"};
+   }
+   k += sizeof("status=\"") - 1;
+   l = issue_data.find('"', k);
+   if (l == std::string::npos) {
+      throw bad_issue_file{filename, "Corrupt status attribute"};
+   }
+   issue_data.replace(k, l-k, new_status);
+
+   write_file_atomically(filename, issue_data);
+}
+
+void apply_status_changes(std::string const & issues_path, std::vector<status_change> & changes) {
+   // Rewrite each issue file named by 'changes' concurrently, recording the outcome of
+   // each change in its 'result' and 'succeeded' members.  Each issue is written by
+   // exactly one worker, so the workers share nothing but the index of the next job.
+
+   std::atomic<std::size_t> next_change{0};
+   auto worker = [&] {
+      for (auto i = next_change++; i < changes.size(); i = next_change++) {
+         auto & change = changes[i];
+         try {
+            set_issue_status(issues_path + change.issue_file, change.issue_number, change.new_status);
+            change.result = "set to " + change.new_status;
+            change.succeeded = true;
+         }
+         catch (std::exception const & ex) {
+            change.result = ex.what();
+         }
+      }
+   };
+
+   auto const thread_count = std::min<std::size_t>(changes.size(), std::max(1u, std::thread::hardware_concurrency()));
+   std::vector<std::thread> threads;
+   for (std::size_t i{1}; i < thread_count; ++i) {
+      threads.emplace_back(worker);
+   }
+   worker();
+   for (auto & t : threads) {
+      t.join();
+   }
+}
+
 void check_is_directory(std::string const & directory) {
    struct stat sb;
    if (stat(directory.c_str(), &sb) != 0 or !S_ISDIR(sb.st_mode)) {
@@ -77,8 +243,9 @@ int main(int argc, char const * argv[]) {
    try {
       bool trace_on{false};  // Will pick this up from the command line later
 
-      if (argc != 3) {
-         std::cerr << "Must specify exactly one issue, followed by its new status\n";
+      bool const batch_mode{argc >= 2  and  std::string{argv[1]} == "--batch"};
+      if ((batch_mode  and  argc > 3)  or  (!batch_mode  and  (argc < 3  or  argc % 2 == 0))) {
+         std::cerr << "Must specify one or more issues, each followed by its new status, or --batch [file]\n";
 //         for (auto arg : argv) {
          for (int i{0}; argc != i;  ++i) {
             char const * arg = argv[i];
@@ -87,11 +254,31 @@ int main(int argc, char const * argv[]) {
          return -2;
       }
 
-      int const issue_number = atoi(argv[1]);
+      // Validate every request before touching any file
+      std::vector<status_change> changes;
+      if (batch_mode  and  argc == 3) {
+         std::ifstream infile{argv[2]};
+         if (!infile.is_open()) {
+            throw std::runtime_error{std::string{"Unable to open file "} + argv[2]};
+         }
+         changes = read_status_changes(infile);
+      }
+      else if (batch_mode) {
+         changes = read_status_changes(std::cin);
+      }
+      else {
+         for (int i{1}; i < argc; i += 2) {
+            changes.push_back(make_status_change(argv[i], argv[i+1]));
+         }
+      }
+
+      std::set<int> seen;
+      for (auto const & change : changes) {
+         if (!seen.insert(change.issue_number).second) {
+            throw std::runtime_error{"Issue " + std::to_string(change.issue_number) + " is requested more than once"};
+         }
+      }
 
-      std::string new_status{argv[2]};
-      std::replace(new_status.begin(), new_status.end(), '_', ' ');  // simplifies unix shell scripting
-  
       std::string path;
       char cwd[1024];
       if (getcwd(cwd, sizeof(cwd)) == 0) {
@@ -102,48 +289,21 @@ int main(int argc, char const * argv[]) {
       if (path.back() != '/') { path.push_back('/'); }
 
       check_is_directory(path);
-
-      std::string issue_file = std::string{"issue"} + argv[1] + ".xml";
-      auto const filename = path + "xml/" + issue_file;
-
-      auto issue_data = read_file_into_string(filename);
-
-      // find 'status' tag and replace it
-      auto k = issue_data.find("<issue num=\"");
-      if (k == std::string::npos) {
-         throw bad_issue_file{filename, "Unable to find issue number"};
-      }
-      k += sizeof("<issue num=\"") - 1;
-      auto l = issue_data.find('"', k);
-      if (l == std::string::npos) {
-         throw bad_issue_file{filename, "Corrupt issue number attribute"};
-      }
-      if (std::stod(issue_data.substr(k, k-l)) != issue_number) {
-         throw bad_issue_file{filename, "Issue number does not match filename"};
+      if (trace_on) {
+         std::cout << "Updating " << changes.size() << " issues in " << path << "xml/" << std::endl;
       }
 
-      k = issue_data.find("status=\"");
-      if (k == std::string::npos) {
-         throw bad_issue_file{filename, "Unable to find issue status"};
-      }
-      k += sizeof("status=\"") - 1;
-      l = issue_data.find('"', k);
-      if (l == std::string::npos) {
-         throw bad_issue_file{filename, "Corrupt status attribute"};
-      }
-      issue_data.replace(k, l-k, new_status);
+      apply_status_changes(path + "xml/", changes);
 
-      std::ofstream out_file{filename};
-      if (!out_file.is_open()) {
-         throw std::runtime_error{"Unable to re-open file " + filename};
+      bool all_succeeded{true};
+      for (auto const & change : changes) {
+         std::cout << change.issue_number << ": " << change.result << '\n';
+         all_succeeded = all_succeeded  and  change.succeeded;
       }
-
-      out_file << issue_data;
+      return all_succeeded ? 0 : -1;
    }
    catch(std::exception const & ex) {
       std::cout << ex.what() << std::endl;
       return -1;
    }
 }
-
-
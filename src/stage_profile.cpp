@@ -0,0 +1,120 @@
+#include "stage_profile.h"
+
+#include "allocation.h"
+
+#include <chrono>
+#include <ostream>
+
+// platform headers - peak RSS and system time are reported only on a Posix compatible platform
+#if defined(_WIN32)
+#include <ctime>
+#else
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+namespace {
+
+#if !defined(_WIN32)
+auto seconds(timeval const & tv) -> double {
+   return tv.tv_sec + tv.tv_usec / 1e6;
+}
+#endif
+
+auto difference(lwg::stage_sample const & end, lwg::stage_sample const & start) -> lwg::stage_sample {
+   lwg::stage_sample result;
+   result.wall_seconds    = end.wall_seconds    - start.wall_seconds;
+   result.cpu_seconds     = end.cpu_seconds     - start.cpu_seconds;
+   result.allocations     = end.allocations     - start.allocations;
+   result.allocated_bytes = end.allocated_bytes - start.allocated_bytes;
+   result.peak_rss_kb     = end.peak_rss_kb;
+   return result;
+}
+
+void write_json_string(std::ostream & out, std::string const & text) {
+   out << '"';
+   for (char c : text) {
+      if (c == '"'  or  c == '\\') {
+         out << '\\';
+      }
+      out << c;
+   }
+   out << '"';
+}
+
+void write_json_record(std::ostream & out, std::string const & name, lwg::stage_sample const & cost) {
+   out << "{\"name\": ";
+   write_json_string(out, name);
+   out << ", \"wall_seconds\": "    << cost.wall_seconds
+       << ", \"cpu_seconds\": "     << cost.cpu_seconds
+       << ", \"allocations\": "     << cost.allocations
+       << ", \"allocated_bytes\": " << cost.allocated_bytes
+       << ", \"peak_rss_kb\": "     << cost.peak_rss_kb
+       << '}';
+}
+
+} // close unnamed namespace
+
+
+namespace lwg
+{
+
+stage_profile::stage_profile(bool enabled)
+   : enabled_{enabled}
+   , start_{enabled ? sample_now() : stage_sample{}}
+   , stages_{}
+   {
+}
+
+auto stage_profile::sample_now() -> stage_sample {
+   stage_sample result;
+   result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+#if defined(_WIN32)
+   result.cpu_seconds = double(std::clock()) / CLOCKS_PER_SEC;
+#else
+   rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) == 0) {
+      result.cpu_seconds = seconds(usage.ru_utime) + seconds(usage.ru_stime);
+#if defined(__APPLE__)
+      result.peak_rss_kb = usage.ru_maxrss / 1024;  // reported in bytes, rather than kilobytes
+#else
+      result.peak_rss_kb = usage.ru_maxrss;
+#endif
+   }
+#endif
+
+   result.allocations     = allocation_count();
+   result.allocated_bytes = allocated_bytes();
+   return result;
+}
+
+void stage_profile::write_json(std::ostream & out) const {
+   out << "{\n"
+          "  \"stages\": [\n";
+   for (auto const & stage : stages_) {
+      out << "    ";
+      write_json_record(out, stage.name, stage.cost);
+      out << (&stage == &stages_.back() ? "\n" : ",\n");
+   }
+   out << "  ],\n"
+          "  \"total\": ";
+   write_json_record(out, "total", difference(sample_now(), start_));
+   out << "\n}\n";
+}
+
+
+stage_profile::scoped_stage::scoped_stage(stage_profile & profile, std::string const & name)
+   : profile(profile)
+   , name(name)
+   , start{profile.enabled_ ? sample_now() : stage_sample{}}
+   {
+}
+
+stage_profile::scoped_stage::~scoped_stage() {
+   if (profile.enabled_) {
+      profile.stages_.push_back(stage_record{name, difference(sample_now(), start)});
+   }
+}
+
+} // close namespace lwg
@@ -0,0 +1,68 @@
+#ifndef INCLUDE_LWG_STAGE_PROFILE_H
+#define INCLUDE_LWG_STAGE_PROFILE_H
+
+// Per-stage measurements of a program run, so that a slow run can be traced to the stage that regressed.
+// Allocations are counted by the global 'operator new' in 'allocation.cpp', which must also be linked.
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace lwg
+{
+
+struct stage_sample {
+   double       wall_seconds    = 0.0;
+   double       cpu_seconds     = 0.0;  // user plus system time of the whole process
+   std::size_t  allocations     = 0;    // calls to the global 'operator new'
+   std::size_t  allocated_bytes = 0;    // total bytes requested from the global 'operator new'
+   long         peak_rss_kb     = 0;    // high-water mark of the process, not of the stage alone
+};
+
+struct stage_record {
+   std::string   name;
+   stage_sample  cost;                  // differences over the stage, except for 'peak_rss_kb'
+};
+
+class stage_profile {
+public:
+   explicit stage_profile(bool enabled);
+      // A disabled profile runs each stage without taking any measurement.
+
+   auto enabled() const noexcept -> bool { return enabled_; }
+
+   template <typename Stage>
+   auto measure(std::string const & name, Stage stage) -> decltype(stage());
+      // Call 'stage()', record its cost under 'name', and return its result.
+
+   void write_json(std::ostream & out) const;
+      // Write every recorded stage, in the order run, followed by the total for the whole run.
+
+private:
+   struct scoped_stage {
+      scoped_stage(stage_profile & profile, std::string const & name);
+      ~scoped_stage();
+
+      stage_profile & profile;
+      std::string     name;
+      stage_sample    start;
+   };
+
+   static auto sample_now() -> stage_sample;
+
+   bool                       enabled_;
+   stage_sample               start_;
+   std::vector<stage_record>  stages_;
+};
+
+
+template <typename Stage>
+auto stage_profile::measure(std::string const & name, Stage stage) -> decltype(stage()) {
+   scoped_stage scope{*this, name};
+   return stage();
+}
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_STAGE_PROFILE_H
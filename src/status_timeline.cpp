@@ -0,0 +1,320 @@
+// This program reads a directory of archived TOC snapshots, one per mailing, and reports how the status
+// of each issue changed over those revisions.
+//
+// Usage:
+//    status_timeline DIR                       timeline of every issue
+//    status_timeline DIR --issue NUM           timeline of issue NUM (may be repeated)
+//    status_timeline DIR --dwell STATUS        how many consecutive mailings issues spent in STATUS
+//    status_timeline DIR --between REV1 REV2   revision history entry for the changes from REV1 to REV2
+//
+// Each archived revision is a '.txt' snapshot written by 'lists', or an old 'lwg-toc.html' when no
+// snapshot was kept; the file name, less its extension, names the revision.  Revisions are ordered by
+// name, comparing runs of digits numerically so that R9 precedes R10.  Underscores in a STATUS are
+// read as spaces, which simplifies unix shell scripting.
+//
+// All snapshots are parsed exactly once, into a compact columnar table of one status code per issue
+// per revision, and every query is answered from that table.
+
+// standard headers
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// platform headers - requires a Posix compatible platform
+// The hope is to replace all of this with the filesystem TS
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+// solution specific headers
+#include "issues.h"
+#include "revision_diff.h"
+#include "toc_snapshot.h"
+
+
+auto natural_less(std::string const & x, std::string const & y) -> bool {
+   // Order revision names such as "R9" before "R10", by comparing runs of digits by value.
+   std::string::size_type i{0}, j{0};
+   while (i < x.size()  and  j < y.size()) {
+      if (std::isdigit(x[i])  and  std::isdigit(y[j])) {
+         auto const xe = x.find_first_not_of("0123456789", i);
+         auto const ye = y.find_first_not_of("0123456789", j);
+         auto const xn = x.substr(i, xe == std::string::npos ? std::string::npos : xe - i);
+         auto const yn = y.substr(j, ye == std::string::npos ? std::string::npos : ye - j);
+         auto const xv = xn.substr(std::min(xn.find_first_not_of('0'), xn.size()));
+         auto const yv = yn.substr(std::min(yn.find_first_not_of('0'), yn.size()));
+         if (xv.size() != yv.size()) {
+            return xv.size() < yv.size();
+         }
+         if (xv != yv) {
+            return xv < yv;
+         }
+         i = (xe == std::string::npos) ? x.size() : xe;
+         j = (ye == std::string::npos) ? y.size() : ye;
+      }
+      else if (x[i] != y[j]) {
+         return x[i] < y[j];
+      }
+      else {
+         ++i;
+         ++j;
+      }
+   }
+   return x.size() - i < y.size() - j;
+}
+
+auto find_archived_revisions(std::string const & archive_path) -> std::vector<std::string> {
+   // Return the name of each revision archived in 'archive_path', in revision order.
+
+   std::unique_ptr<DIR, int(&)(DIR*)> dir{opendir(archive_path.c_str()), closedir};
+   if (!dir) {
+      throw std::runtime_error{"Unable to open archive dir " + archive_path};
+   }
+
+   std::set<std::string> names;
+   while ( dirent* entry = readdir(dir.get()) ) {
+      std::string const file{ entry->d_name };
+      for (std::string const extension : {".txt", ".html"}) {
+         if (file.size() > extension.size()  and  0 == file.compare(file.size() - extension.size(), extension.size(), extension)) {
+            names.insert(file.substr(0, file.size() - extension.size()));
+         }
+      }
+   }
+
+   std::vector<std::string> revisions{names.begin(), names.end()};
+   std::sort(revisions.begin(), revisions.end(), natural_less);
+   return revisions;
+}
+
+// ============================================================================================================
+
+struct status_history {
+   // The status of every issue in every archived revision, held as a dense table of one-byte codes.
+   // Row 'i' of the table holds the history of 'issues[i]', one column per revision, so that the
+   // timeline of an issue is contiguous.  Codes index the 'statuses' dictionary, which is kept in
+   // 'get_status_priority' order, so comparing codes compares status priorities.
+
+   static constexpr unsigned char absent = 0xFF;   // issue is not listed in a revision
+
+   std::vector<std::string>    revisions;  // revision names, oldest first
+   std::vector<int>            issues;     // every issue listed in any revision, sorted by number
+   std::vector<std::string>    statuses;   // dictionary of every status seen
+   std::vector<unsigned char>  codes;      // issues.size() x revisions.size() status codes
+
+   auto code(std::size_t issue_index, std::size_t revision_index) const -> unsigned char {
+      return codes[issue_index * revisions.size() + revision_index];
+   }
+
+   auto revision_index(std::string const & name) const -> std::size_t {
+      auto const i = std::find(revisions.begin(), revisions.end(), name);
+      if (i == revisions.end()) {
+         throw std::runtime_error{"Unknown revision " + name};
+      }
+      return i - revisions.begin();
+   }
+
+   auto issue_index(int num) const -> std::size_t {
+      auto const i = std::lower_bound(issues.begin(), issues.end(), num);
+      if (i == issues.end()  or  *i != num) {
+         throw std::runtime_error{"Issue " + std::to_string(num) + " is not listed in any revision"};
+      }
+      return i - issues.begin();
+   }
+
+   auto snapshot(std::size_t revision_index) const -> lwg::toc_snapshot {
+      // Return the issue numbers and statuses of the specified revision.
+      lwg::toc_snapshot result;
+      for (std::size_t i{0}; i != issues.size(); ++i) {
+         auto const c = code(i, revision_index);
+         if (c != absent) {
+            lwg::toc_entry entry;
+            entry.num = issues[i];
+            entry.stat = statuses[c];
+            result.push_back(std::move(entry));
+         }
+      }
+      return result;
+   }
+};
+
+constexpr unsigned char status_history::absent;
+
+auto read_status_history(std::string const & archive_path) -> status_history {
+   status_history history;
+   history.revisions = find_archived_revisions(archive_path);
+
+   std::vector<lwg::toc_snapshot> snapshots;
+   for (auto const & revision : history.revisions) {
+      snapshots.push_back(lwg::load_toc_snapshot(archive_path + revision + ".html"));
+   }
+
+   std::set<std::string> statuses;
+   for (auto const & snapshot : snapshots) {
+      for (auto const & entry : snapshot) {
+         history.issues.push_back(entry.num);
+         statuses.insert(entry.stat);
+      }
+   }
+   std::sort(history.issues.begin(), history.issues.end());
+   history.issues.erase(std::unique(history.issues.begin(), history.issues.end()), history.issues.end());
+
+   history.statuses.assign(statuses.begin(), statuses.end());
+   std::stable_sort(history.statuses.begin(), history.statuses.end(), [](std::string const & x, std::string const & y) {
+      return lwg::get_status_priority(x) < lwg::get_status_priority(y);
+   });
+   if (history.statuses.size() >= status_history::absent) {
+      throw std::runtime_error{"Too many distinct statuses in archive " + archive_path};
+   }
+
+   std::map<std::string, unsigned char> status_codes;
+   for (std::size_t c{0}; c != history.statuses.size(); ++c) {
+      status_codes[history.statuses[c]] = static_cast<unsigned char>(c);
+   }
+
+   // Fill each column by merging its snapshot, sorted by issue number, against the sorted issue list
+   auto const columns = history.revisions.size();
+   history.codes.assign(history.issues.size() * columns, status_history::absent);
+   for (std::size_t r{0}; r != columns; ++r) {
+      std::size_t row{0};
+      for (auto const & entry : snapshots[r]) {
+         while (history.issues[row] != entry.num) {
+            ++row;
+         }
+         history.codes[row * columns + r] = status_codes[entry.stat];
+      }
+   }
+
+   return history;
+}
+
+// ============================================================================================================
+
+void print_timeline(std::ostream & out, status_history const & history, std::size_t issue_index) {
+   // Write the issue number, followed by each revision in which its status changed, on one line.
+   out << history.issues[issue_index] << ':';
+   unsigned char previous{status_history::absent};
+   for (std::size_t r{0}; r != history.revisions.size(); ++r) {
+      auto const c = history.code(issue_index, r);
+      if (c != previous) {
+         out << "  " << history.revisions[r] << ' ' << (c == status_history::absent ? "(removed)" : history.statuses[c]);
+         previous = c;
+      }
+   }
+   out << '\n';
+}
+
+void print_dwell_times(std::ostream & out, status_history const & history, std::string const & status) {
+   // For every issue that was ever in 'status', report the number of consecutive revisions it stayed
+   // there, counting each separate stay.  Stays still open at the latest revision are marked with '+'.
+   auto const s = std::find(history.statuses.begin(), history.statuses.end(), status);
+   if (s == history.statuses.end()) {
+      out << "No issue has been " << status << " in any archived revision\n";
+      return;
+   }
+   auto const wanted = static_cast<unsigned char>(s - history.statuses.begin());
+   auto const columns = history.revisions.size();
+
+   std::size_t stays{0}, total{0}, longest{0};
+   for (std::size_t i{0}; i != history.issues.size(); ++i) {
+      std::vector<std::size_t> lengths;
+      std::size_t run{0};
+      for (std::size_t r{0}; r != columns; ++r) {
+         if (history.code(i, r) == wanted) {
+            ++run;
+         }
+         else if (run != 0) {
+            lengths.push_back(run);
+            run = 0;
+         }
+      }
+      if (run != 0) {
+         lengths.push_back(run);
+      }
+      if (lengths.empty()) {
+         continue;
+      }
+
+      out << history.issues[i] << ':';
+      for (std::size_t k{0}; k != lengths.size(); ++k) {
+         out << ' ' << lengths[k];
+         if (k + 1 == lengths.size()  and  history.code(i, columns - 1) == wanted) {
+            out << '+';
+         }
+         ++stays;
+         total += lengths[k];
+         longest = std::max(longest, lengths[k]);
+      }
+      out << '\n';
+   }
+
+   out << stays << " stays in " << status << ", averaging " << (double(total) / stays)
+       << " revisions, longest " << longest << " revisions\n";
+}
+
+// ============================================================================================================
+
+void check_is_directory(std::string const & directory) {
+   struct stat sb;
+   if (stat(directory.c_str(), &sb) != 0 or !S_ISDIR(sb.st_mode)) {
+      throw std::runtime_error(directory + " is not an existing directory");
+   }
+}
+
+int main(int argc, char const * argv[]) {
+   try {
+      if (argc < 2) {
+         std::cerr << "Must specify the directory of archived TOC snapshots, optionally followed by queries:\n"
+                      "\t--issue NUM\n"
+                      "\t--dwell STATUS\n"
+                      "\t--between REV1 REV2\n";
+         return 2;
+      }
+
+      std::string path{argv[1]};
+      if (path.back() != '/') { path.push_back('/'); }
+      check_is_directory(path);
+
+      auto const history = read_status_history(path);
+      if (history.revisions.empty()) {
+         throw std::runtime_error{"No TOC snapshots found in " + path};
+      }
+
+      if (argc == 2) {
+         for (std::size_t i{0}; i != history.issues.size(); ++i) {
+            print_timeline(std::cout, history, i);
+         }
+         return 0;
+      }
+
+      for (int i{2}; i < argc; ++i) {
+         std::string const query{argv[i]};
+         if (query == "--issue"  and  i + 1 < argc) {
+            print_timeline(std::cout, history, history.issue_index(std::stoi(argv[++i])));
+         }
+         else if (query == "--dwell"  and  i + 1 < argc) {
+            std::string status{argv[++i]};
+            std::replace(status.begin(), status.end(), '_', ' ');
+            print_dwell_times(std::cout, history, status);
+         }
+         else if (query == "--between"  and  i + 2 < argc) {
+            auto const from = history.revision_index(argv[++i]);
+            auto const to   = history.revision_index(argv[++i]);
+            lwg::print_current_revisions(std::cout, history.snapshot(from), history.snapshot(to));
+         }
+         else {
+            throw std::runtime_error{"Unknown or incomplete query " + query};
+         }
+      }
+   }
+   catch(std::exception const & ex) {
+      std::cout << ex.what() << std::endl;
+      return 1;
+   }
+}
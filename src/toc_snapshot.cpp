@@ -0,0 +1,194 @@
+#include "toc_snapshot.h"
+
+#include "issues.h"
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+static constexpr char const * SNAPSHOT_HEADER{"# lwg-toc snapshot 1"};
+
+auto snapshot_filename_for(std::string const & toc_filename) -> std::string {
+   auto const dot = toc_filename.rfind(".html");
+   return (dot == std::string::npos  or  dot + 5 != toc_filename.size())
+        ? toc_filename + ".txt"
+        : toc_filename.substr(0, dot) + ".txt";
+}
+
+void write_field(std::ostream & out, std::string const & field) {
+   // Tabs and line breaks are the only characters with meaning in the snapshot format,
+   // so fold them into plain spaces.
+   for (auto c : field) {
+      out << ((c == '\t'  or  c == '\n'  or  c == '\r') ? ' ' : c);
+   }
+}
+
+auto split_fields(std::string const & line) -> std::vector<std::string> {
+   std::vector<std::string> fields;
+   std::string::size_type i{0};
+   for (auto j = line.find('\t'); j != std::string::npos; j = line.find('\t', i)) {
+      fields.emplace_back(line, i, j-i);
+      i = j + 1;
+   }
+   fields.emplace_back(line, i);
+   return fields;
+}
+
+auto split_tags(std::string const & tags) -> std::vector<lwg::section_tag> {
+   std::vector<lwg::section_tag> result;
+   std::istringstream in{tags};
+   std::copy(std::istream_iterator<std::string>{in}, std::istream_iterator<std::string>{}, back_inserter(result));
+   return result;
+}
+
+void sort_by_issue_number(lwg::toc_snapshot & snapshot) {
+   auto const by_number = [](lwg::toc_entry const & x, lwg::toc_entry const & y) { return x.num < y.num; };
+   if (!std::is_sorted(snapshot.begin(), snapshot.end(), by_number)) {
+      std::stable_sort(snapshot.begin(), snapshot.end(), by_number);
+   }
+}
+
+} // close unnamed namespace
+
+auto lwg::make_toc_snapshot(std::vector<issue> const & issues) -> toc_snapshot {
+   toc_snapshot result;
+   result.reserve(issues.size());
+   for (auto const & iss : issues) {
+      toc_entry entry;
+      entry.num = iss.num;
+      entry.stat = iss.stat;
+      entry.priority = iss.priority;
+      entry.tags = iss.tags;
+      entry.title = iss.title;
+      result.push_back(std::move(entry));
+   }
+   sort_by_issue_number(result);
+   return result;
+}
+
+void lwg::write_toc_snapshot(std::ostream & out, toc_snapshot const & snapshot) {
+   out << SNAPSHOT_HEADER << '\n';
+   for (auto const & entry : snapshot) {
+      out << entry.num << '\t';
+      write_field(out, entry.stat);
+      out << '\t' << entry.priority << '\t';
+      char const * sep{""};
+      for (auto const & tag : entry.tags) {
+         out << sep;
+         write_field(out, tag);
+         sep = " ";
+      }
+      out << '\t';
+      write_field(out, entry.title);
+      out << '\n';
+   }
+}
+
+auto lwg::read_toc_snapshot(std::istream & in) -> toc_snapshot {
+   toc_snapshot result;
+   std::string line;
+   for (unsigned line_number{1}; getline(in, line); ++line_number) {
+      if (!line.empty()  and  line.back() == '\r') {
+         line.pop_back();
+      }
+      if (line.empty()  or  line[0] == '#') {
+         continue;
+      }
+
+      auto const fields = split_fields(line);
+      if (fields.size() < 2  or  fields[1].empty()) {
+         throw std::runtime_error{"toc snapshot line " + std::to_string(line_number) + " has no status"};
+      }
+
+      toc_entry entry;
+      try {
+         entry.num = std::stoi(fields[0]);
+         if (fields.size() > 2  and  !fields[2].empty()) {
+            entry.priority = std::stoi(fields[2]);
+         }
+      }
+      catch (std::exception const &) {
+         throw std::runtime_error{"toc snapshot line " + std::to_string(line_number) + " has a bad number"};
+      }
+      entry.stat = fields[1];
+      if (fields.size() > 3) {
+         entry.tags = split_tags(fields[3]);
+      }
+      if (fields.size() > 4) {
+         entry.title = fields[4];
+      }
+      result.push_back(std::move(entry));
+   }
+
+   sort_by_issue_number(result);
+   return result;
+}
+
+auto lwg::read_toc_snapshot_from_html(std::string const & s) -> toc_snapshot {
+   // The TOC file consists of a sequence of HTML <tr> elements - each element is one issue/row in the table
+   //    First we search the string for the first <tr> marker
+   //       The first row is the title row and does not contain an issue.
+   //       If cannt find the first row, we flag an error and exit
+   //    Next we loop through the string, searching for <tr> markers to indicate the start of each issue
+   //       We parse the issue number and status from each row, and append a record to the result vector
+   //       If any parse fails, throw a runtime_error
+
+   // Skip the title row
+   auto i = s.find("<tr>");
+   if (std::string::npos == i) {
+      throw std::runtime_error{"Unable to find the first (title) row"};
+   }
+
+   // Read all issues in table
+   toc_snapshot issues;
+   for(;;) {
+      i = s.find("<tr>", i+4);
+      if (i == std::string::npos) {
+         break;
+      }
+      i = s.find("</a>", i);
+      auto j = s.rfind('>', i);
+      if (j == std::string::npos) {
+         throw std::runtime_error{"unable to parse issue number: can't find beginning bracket"};
+      }
+      std::istringstream instr{s.substr(j+1, i-j-1)};
+      toc_entry entry;
+      instr >> entry.num;
+      if (instr.fail()) {
+         throw std::runtime_error{"unable to parse issue number"};
+      }
+      i = s.find("</a>", i+4);
+      if (i == std::string::npos) {
+         throw std::runtime_error{"partial issue found"};
+      }
+      j = s.rfind('>', i);
+      if (j == std::string::npos) {
+         throw std::runtime_error{"unable to parse issue status: can't find beginning bracket"};
+      }
+      entry.stat = s.substr(j+1, i-j-1);
+      issues.push_back(std::move(entry));
+   }
+
+   sort_by_issue_number(issues);
+   return issues;
+}
+
+auto lwg::load_toc_snapshot(std::string const & toc_filename) -> toc_snapshot {
+   std::ifstream snapshot{snapshot_filename_for(toc_filename)};
+   if (snapshot.is_open()) {
+      return read_toc_snapshot(snapshot);
+   }
+
+   std::ifstream html{toc_filename};
+   if (!html.is_open()) {
+      throw std::runtime_error{"Unable to open toc file: " + toc_filename};
+   }
+   std::istreambuf_iterator<char> first{html}, last{};
+   return read_toc_snapshot_from_html(std::string{first, last});
+}
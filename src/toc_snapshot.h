@@ -0,0 +1,56 @@
+#ifndef INCLUDE_LWG_TOC_SNAPSHOT_H
+#define INCLUDE_LWG_TOC_SNAPSHOT_H
+
+// A 'toc_snapshot' is a compact, machine-readable record of the table of contents of an issues list,
+// written by 'lists' alongside 'lwg-toc.html' so that later revisions can be diffed against it without
+// scraping HTML.  The file format is line-oriented, with one issue per line sorted by issue number:
+//
+//    # lwg-toc snapshot 1
+//    NUM<TAB>STATUS<TAB>PRIORITY<TAB>SECTION-TAGS<TAB>TITLE
+//
+// where SECTION-TAGS is a space-separated list of the issue's section tags.  Lines beginning with '#'
+// are comments.  Only NUM and STATUS are required, so a snapshot can be recovered from an old HTML TOC.
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace lwg
+{
+
+struct issue;
+
+using section_tag = std::string;
+
+struct toc_entry {
+   int                       num;            // ID - issue number
+   std::string               stat;           // status of the issue when the snapshot was taken
+   int                       priority = 99;  // 99 = not yet prioritised, or unknown for a snapshot recovered from HTML
+   std::vector<section_tag>  tags;           // section(s) of the standard affected by the issue
+   std::string               title;          // descriptive title for the issue, as HTML
+};
+
+using toc_snapshot = std::vector<toc_entry>;
+   // Always sorted by issue number.
+
+auto make_toc_snapshot(std::vector<issue> const & issues) -> toc_snapshot;
+   // Return a snapshot of the specified 'issues', which need not be sorted.
+
+void write_toc_snapshot(std::ostream & out, toc_snapshot const & snapshot);
+auto read_toc_snapshot(std::istream & in) -> toc_snapshot;
+   // Write/read a snapshot in the line-oriented format above.  Reading throws
+   // 'runtime_error' if any line cannot be parsed.
+
+auto read_toc_snapshot_from_html(std::string const & html) -> toc_snapshot;
+   // Recover the issue number and status of each issue from a "toc" html document, such as an
+   // 'lwg-toc.html' generated before snapshots were available.  Throws 'runtime_error' if the
+   // table cannot be parsed.
+
+auto load_toc_snapshot(std::string const & toc_filename) -> toc_snapshot;
+   // Load the snapshot stored alongside the "toc" html document 'toc_filename', i.e., with
+   // its '.html' extension replaced by '.txt'.  If there is no such file, fall back to parsing
+   // the html document itself.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_TOC_SNAPSHOT_H